@@ -7,7 +7,8 @@ _comp_cmd_dmidecode() {
 	prev=${COMP_WORDS[COMP_CWORD - 1]}
 
 	case $prev in
-	-d | --dev-mem | --dump-bin | --from-dump)
+	-d | --dev-mem | --dump-bin | --from-dump | --store | --diff | --daemon | \
+	--prometheus)
 		if [[ $prev == -d || $prev == --dev-mem ]]; then
 			: "${cur:=/dev/}"
 		fi
@@ -24,13 +25,27 @@ _comp_cmd_dmidecode() {
 		COMPREPLY=($(compgen -W '$("$1" --list-types)' -- "$cur"))
 		return 0
 		;;
+	--field | --match)
+		local IFS=$'\n'
+		COMPREPLY=($(compgen -W '$("$1" --list-fields)' -- "$cur"))
+		return 0
+		;;
 	--dump-bin | --from-dump)
 		local IFS=$'\n'
 		compopt -o filenames
 		COMPREPLY=($(compgen -f -- "$cur"))
 		return 0
 		;;
-	-[hVH] | --help | --version | --handle | --oem-string)
+	--summary)
+		COMPREPLY=($(compgen -W 'memory cpu errors' -- "$cur"))
+		return 0
+		;;
+	--csv)
+		COMPREPLY=($(compgen -W '$("$1" --list-fields | cut -d. -f1 | uniq)' -- "$cur"))
+		return 0
+		;;
+	-[hVH] | --help | --version | --handle | --oem-string | --oem-key | --jobs | \
+	--format | --publish | --from-shm | --watch | --locate-address)
 		return 0
 		;;
 	esac
@@ -44,12 +59,38 @@ _comp_cmd_dmidecode() {
 			--list-strings
 			--type
 			--list-types
+			--field
+			--list-fields
+			--match
 			--handle
 			--dump
 			--dump-bin
+			--dump-index
 			--from-dump
+			--store
+			--diff
+			--fingerprint
 			--no-sysfs
+			--jobs
+			--csv
+			--export
+			--format
+			--daemon
+			--replace
+			--publish
+			--from-shm
+			--watch
+			--prometheus
+			--locate-address
+			--summary
+			--tree
+			--pci-map
+			--json
 			--oem-string
+			--oem-key
+			--event-log
+			--redfish
+			--ipmi
 			--version
 		' -- "$cur"))
 		return 0
@@ -0,0 +1,222 @@
+/*
+ * Query daemon
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * The daemon keeps the DMI table in memory and answers requests on a Unix
+ * socket. A client connects, sends a single request line (see
+ * parse_query()), and reads the answer until the daemon closes the
+ * connection. Each request is handled by a child process, so that the
+ * decoder state and any memory allocated while answering are discarded
+ * afterwards, and a slow client doesn't delay the others. As other users
+ * may be allowed to connect, the number of children is limited; further
+ * connections wait in the listen queue until a child exits.
+ */
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "dmiopt.h"
+#include "dmidaemon.h"
+
+#define REQUEST_MAX		1024
+#define REQUEST_TIMEOUT		5	/* Seconds */
+#define CHILDREN_MAX		16
+
+static volatile sig_atomic_t dmi_daemon_children;
+
+static void dmi_daemon_reap(int sig)
+{
+	int saved_errno = errno;
+
+	(void)sig;
+	while (waitpid(-1, NULL, WNOHANG) > 0)
+		dmi_daemon_children--;
+	errno = saved_errno;
+}
+
+static int dmi_daemon_listen(const char *path)
+{
+	struct sockaddr_un addr;
+	int fd;
+
+	if (strlen(path) >= sizeof(addr.sun_path))
+	{
+		fprintf(stderr, "%s: Socket path too long\n", path);
+		return -1;
+	}
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+
+	if ((opt.flags & FLAG_REPLACE) && unlink(path) == -1 && errno != ENOENT)
+	{
+		fprintf(stderr, "%s: ", path);
+		perror("unlink");
+		return -1;
+	}
+
+	if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) == -1)
+	{
+		perror("socket");
+		return -1;
+	}
+
+	/* Permissions follow the umask, which lets the caller choose */
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1)
+	{
+		if (errno == EADDRINUSE)
+			fprintf(stderr, "%s: File exists, use --replace to "
+				"replace it\n", path);
+		else
+		{
+			fprintf(stderr, "%s: ", path);
+			perror("bind");
+		}
+		close(fd);
+		return -1;
+	}
+
+	if (listen(fd, 16) == -1)
+	{
+		fprintf(stderr, "%s: ", path);
+		perror("listen");
+		close(fd);
+		unlink(path);
+		return -1;
+	}
+
+	return fd;
+}
+
+/* Read the request line, returns -1 on error or timeout */
+static int dmi_daemon_request(int fd, char *buf, size_t size)
+{
+	struct timeval tv = { REQUEST_TIMEOUT, 0 };
+	size_t len = 0;
+
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+	while (len < size - 1)
+	{
+		ssize_t r = read(fd, buf + len, size - 1 - len);
+
+		if (r == -1 && errno == EINTR)
+			continue;
+		if (r <= 0)
+			break;
+		len += r;
+		if (memchr(buf + len - r, '\n', r) != NULL)
+			break;
+	}
+	buf[len] = '\0';
+
+	return len ? 0 : -1;
+}
+
+static void dmi_daemon_serve(int fd, void (*query)(void),
+			     const sigset_t *mask)
+{
+	char request[REQUEST_MAX];
+
+	signal(SIGCHLD, SIG_DFL);
+	signal(SIGPIPE, SIG_DFL);
+	sigprocmask(SIG_SETMASK, mask, NULL);
+	if (dmi_daemon_request(fd, request, sizeof(request)) != 0
+	 || dup2(fd, STDOUT_FILENO) == -1 || dup2(fd, STDERR_FILENO) == -1)
+		_exit(1);
+	close(fd);
+
+	if (parse_query(request) == 0)
+		query();
+	fflush(stdout);
+	_exit(ferror(stdout) ? 1 : 0);
+}
+
+/*
+ * Answer requests until killed. refresh() is called before each request,
+ * so that the table can be checked for changes, and query() is called by
+ * the child process to answer the request once it was parsed.
+ */
+int dmi_daemon(const char *path, void (*refresh)(void), void (*query)(void))
+{
+	struct sigaction sa;
+	sigset_t chld, mask;
+	int fd, client;
+
+	if ((fd = dmi_daemon_listen(path)) == -1)
+		return -1;
+
+	/* Children are reaped as they exit */
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = dmi_daemon_reap;
+	sa.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGCHLD, &sa, NULL);
+	signal(SIGPIPE, SIG_IGN);
+	sigemptyset(&chld);
+	sigaddset(&chld, SIGCHLD);
+
+	for (;;)
+	{
+		/* The counter is only updated with SIGCHLD blocked */
+		sigprocmask(SIG_BLOCK, &chld, &mask);
+		while (dmi_daemon_children >= CHILDREN_MAX)
+			sigsuspend(&mask);
+		sigprocmask(SIG_SETMASK, &mask, NULL);
+
+		if ((client = accept(fd, NULL, NULL)) == -1)
+		{
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			perror("accept");
+			break;
+		}
+
+		refresh();
+
+		/* Don't let the child inherit pending output */
+		fflush(stdout);
+		fflush(stderr);
+		sigprocmask(SIG_BLOCK, &chld, NULL);
+		switch (fork())
+		{
+			case -1:
+				perror("fork");
+				break;
+			case 0:
+				close(fd);
+				dmi_daemon_serve(client, query, &mask);
+				break;
+			default:
+				dmi_daemon_children++;
+		}
+		sigprocmask(SIG_SETMASK, &mask, NULL);
+		close(client);
+	}
+
+	close(fd);
+	unlink(path);
+	return -1;
+}
@@ -68,8 +68,11 @@
 #include <strings.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <signal.h>
+#include <time.h>
 #include <arpa/inet.h>
 #include <sys/socket.h>
+#include <sys/wait.h>
 
 #if defined(__FreeBSD__) || defined(__DragonFly__)
 #include <errno.h>
@@ -84,6 +87,22 @@
 #include "dmiopt.h"
 #include "dmioem.h"
 #include "dmioutput.h"
+#include "dmidiff.h"
+#include "dmistore.h"
+#include "dmidump.h"
+#include "dmiexport.h"
+#include "dmiformat.h"
+#include "dmidaemon.h"
+#include "dmishm.h"
+#include "dmimetrics.h"
+#include "dmilocate.h"
+#include "dmisummary.h"
+#include "dmitree.h"
+#include "dmipci.h"
+#include "dmioemkey.h"
+#include "dmievent.h"
+#include "dmiredfish.h"
+#include "dmiipmi.h"
 
 static const char *bad_index = "<BAD INDEX>";
 
@@ -94,6 +113,24 @@ enum cpuid_type cpuid_type = cpuid_none;
 #define FLAG_NO_FILE_OFFSET     (1 << 0)
 #define FLAG_STOP_AT_EOT        (1 << 1)
 
+/* Dump image rebuilt from a store record, see --from-dump */
+static const u8 *dump_image;
+static size_t dump_image_len;
+
+/* Table kept instead of being processed, see --diff, --daemon and --watch */
+static struct kept_table
+{
+	u8 *table;
+	u32 len;
+	u16 num;
+	u16 ver;
+	u32 flags;
+	const char *source;
+	u8 ep[0x20];		/* Entry point, if read from sysfs */
+	size_t ep_len;
+} kept_table;
+static int keep_table;
+
 #define SYS_FIRMWARE_DIR "/sys/firmware/dmi/tables"
 #define SYS_ENTRY_FILE SYS_FIRMWARE_DIR "/smbios_entry_point"
 #define SYS_TABLE_FILE SYS_FIRMWARE_DIR "/DMI"
@@ -159,7 +196,7 @@ const char *dmi_string(const struct dmi_header *dm, u8 s)
 	return bp;
 }
 
-static const char *dmi_smbios_structure_type(u8 code)
+const char *dmi_smbios_structure_type(u8 code)
 {
 	static const char *type[] = {
 		"BIOS", /* 0 */
@@ -218,6 +255,114 @@ static const char *dmi_smbios_structure_type(u8 code)
 	return out_of_spec;
 }
 
+/*
+ * Look up the name of an enumerated value. Ranges are stored densely so
+ * this is a couple of compares and an array access.
+ */
+const char *dmi_enum_name(const struct dmi_enum *e, u8 code)
+{
+	unsigned int i;
+
+	code &= e->mask;
+	for (i = 0; i < ARRAY_SIZE(e->range) && e->range[i].count; i++)
+	{
+		const struct dmi_enum_range *r = &e->range[i];
+
+		if (code < r->first)
+			break;
+		if (code - r->first < r->count)
+			return r->names[code - r->first];
+	}
+	return out_of_spec;
+}
+
+/*
+ * Reverse lookup, from name (case-insensitive) to code. Returns -1 if the
+ * name isn't known. Used to turn value filters into plain byte compares.
+ */
+int dmi_enum_code(const struct dmi_enum *e, const char *name)
+{
+	unsigned int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(e->range) && e->range[i].count; i++)
+	{
+		const struct dmi_enum_range *r = &e->range[i];
+
+		for (j = 0; j < r->count; j++)
+			if (strcasecmp(r->names[j], name) == 0)
+				return r->first + j;
+	}
+	return -1;
+}
+
+static unsigned int dmi_ctz(u32 code)
+{
+#ifdef __GNUC__
+	return __builtin_ctz(code);
+#else
+	unsigned int i = 0;
+
+	while (!(code & 1))
+	{
+		code >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
+/* Mask of the bits described by a bit field, others are ignored */
+static u32 dmi_bitfield_mask(const struct dmi_bitfield *b)
+{
+	u32 mask = b->count >= 32 ? ~0U : (1U << b->count) - 1;
+
+	return mask << b->first;
+}
+
+/*
+ * Walk the set bits of code (and only them), returning the number of the
+ * next one and clearing it from code, or -1 when done. Bits which aren't
+ * described are skipped.
+ */
+int dmi_bitfield_next(const struct dmi_bitfield *b, u32 *code)
+{
+	*code &= dmi_bitfield_mask(b);
+	while (*code)
+	{
+		unsigned int i = dmi_ctz(*code);
+
+		*code &= *code - 1;
+		if (b->names[i - b->first] != NULL)
+			return i;
+	}
+	return -1;
+}
+
+/* Print the name of each bit set in code as a list item */
+void dmi_bitfield_list(const struct dmi_bitfield *b, u32 code)
+{
+	int i;
+
+	while ((i = dmi_bitfield_next(b, &code)) >= 0)
+		pr_list_item("%s", b->names[i - b->first]);
+}
+
+/*
+ * Store the names of the bits set in code, separated by spaces. Returns
+ * the length of the resulting string.
+ */
+int dmi_bitfield_join(const struct dmi_bitfield *b, u32 code,
+		      char *buf, size_t size)
+{
+	int i, off = 0;
+
+	buf[0] = '\0';
+	while ((size_t)off < size && (i = dmi_bitfield_next(b, &code)) >= 0)
+		off += snprintf(buf + off, size - off, off ? " %s" : "%s",
+				b->names[i - b->first]);
+	return off;
+}
+
 static int dmi_bcd_range(u8 value, u8 low, u8 high)
 {
 	if (value > 0x99 || (value & 0x0F) > 0x09)
@@ -356,7 +501,7 @@ static void dmi_bios_rom_size(u8 code1, u16 code2)
 static void dmi_bios_characteristics(u64 code)
 {
 	/* 7.1.1 */
-	static const char *characteristics[] = {
+	static const char * const characteristics[] = {
 		"BIOS characteristics not supported", /* 3 */
 		"ISA is supported",
 		"MCA is supported",
@@ -387,7 +532,9 @@ static void dmi_bios_characteristics(u64 code)
 		"CGA/mono video services are supported (int 10h)",
 		"NEC PC-98" /* 31 */
 	};
-	int i;
+	static const struct dmi_bitfield bits = {
+		3, ARRAY_SIZE(characteristics), characteristics
+	};
 
 	/*
 	 * This isn't very clear what this bit is supposed to mean
@@ -398,15 +545,13 @@ static void dmi_bios_characteristics(u64 code)
 		return;
 	}
 
-	for (i = 4; i <= 31; i++)
-		if (code.l & (1 << i))
-			pr_list_item("%s", characteristics[i - 3]);
+	dmi_bitfield_list(&bits, code.l);
 }
 
 static void dmi_bios_characteristics_x1(u8 code)
 {
 	/* 7.1.2.1 */
-	static const char *characteristics[] = {
+	static const char * const characteristics[] = {
 		"ACPI is supported", /* 0 */
 		"USB legacy is supported",
 		"AGP is supported",
@@ -416,17 +561,17 @@ static void dmi_bios_characteristics_x1(u8 code)
 		"IEEE 1394 boot is supported",
 		"Smart battery is supported" /* 7 */
 	};
-	int i;
+	static const struct dmi_bitfield bits = {
+		0, ARRAY_SIZE(characteristics), characteristics
+	};
 
-	for (i = 0; i <= 7; i++)
-		if (code & (1 << i))
-			pr_list_item("%s", characteristics[i]);
+	dmi_bitfield_list(&bits, code);
 }
 
 static void dmi_bios_characteristics_x2(u8 code)
 {
 	/* 37.1.2.2 */
-	static const char *characteristics[] = {
+	static const char * const characteristics[] = {
 		"BIOS boot specification is supported", /* 0 */
 		"Function key-initiated network boot is supported",
 		"Targeted content distribution is supported",
@@ -435,11 +580,11 @@ static void dmi_bios_characteristics_x2(u8 code)
 		"Manufacturing mode is supported",
 		"Manufacturing mode is enabled" /* 6 */
 	};
-	int i;
+	static const struct dmi_bitfield bits = {
+		0, ARRAY_SIZE(characteristics), characteristics
+	};
 
-	for (i = 0; i <= 6; i++)
-		if (code & (1 << i))
-			pr_list_item("%s", characteristics[i]);
+	dmi_bitfield_list(&bits, code);
 }
 
 /*
@@ -509,24 +654,26 @@ static void dmi_system_uuid(void (*print_cb)(const char *name, const char *forma
 	}
 }
 
+/* 7.2.2 */
+static const char * const dmi_system_wake_up_type_names[] = {
+	"Reserved", /* 0x00 */
+	"Other",
+	"Unknown",
+	"APM Timer",
+	"Modem Ring",
+	"LAN Remote",
+	"Power Switch",
+	"PCI PME#",
+	"AC Power Restored" /* 0x08 */
+};
+
+static const struct dmi_enum dmi_system_wake_up_type_enum = {
+	0xFF, { { 0x00, ARRAY_SIZE(dmi_system_wake_up_type_names), dmi_system_wake_up_type_names } }
+};
+
 static const char *dmi_system_wake_up_type(u8 code)
 {
-	/* 7.2.2 */
-	static const char *type[] = {
-		"Reserved", /* 0x00 */
-		"Other",
-		"Unknown",
-		"APM Timer",
-		"Modem Ring",
-		"LAN Remote",
-		"Power Switch",
-		"PCI PME#",
-		"AC Power Restored" /* 0x08 */
-	};
-
-	if (code <= 0x08)
-		return type[code];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_system_wake_up_type_enum, code);
 }
 
 /*
@@ -536,50 +683,51 @@ static const char *dmi_system_wake_up_type(u8 code)
 static void dmi_base_board_features(u8 code)
 {
 	/* 7.3.1 */
-	static const char *features[] = {
+	static const char * const features[] = {
 		"Board is a hosting board", /* 0 */
 		"Board requires at least one daughter board",
 		"Board is removable",
 		"Board is replaceable",
 		"Board is hot swappable" /* 4 */
 	};
+	static const struct dmi_bitfield bits = {
+		0, ARRAY_SIZE(features), features
+	};
 
 	if ((code & 0x1F) == 0)
 		pr_list_start("Features", "%s", "None");
 	else
 	{
-		int i;
-
 		pr_list_start("Features", NULL);
-		for (i = 0; i <= 4; i++)
-			if (code & (1 << i))
-				pr_list_item("%s", features[i]);
+		dmi_bitfield_list(&bits, code);
 	}
 	pr_list_end();
 }
 
+/* 7.3.2 */
+static const char * const dmi_base_board_type_names[] = {
+	"Unknown", /* 0x01 */
+	"Other",
+	"Server Blade",
+	"Connectivity Switch",
+	"System Management Module",
+	"Processor Module",
+	"I/O Module",
+	"Memory Module",
+	"Daughter Board",
+	"Motherboard",
+	"Processor+Memory Module",
+	"Processor+I/O Module",
+	"Interconnect Board" /* 0x0D */
+};
+
+static const struct dmi_enum dmi_base_board_type_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_base_board_type_names), dmi_base_board_type_names } }
+};
+
 static const char *dmi_base_board_type(u8 code)
 {
-	/* 7.3.2 */
-	static const char *type[] = {
-		"Unknown", /* 0x01 */
-		"Other",
-		"Server Blade",
-		"Connectivity Switch",
-		"System Management Module",
-		"Processor Module",
-		"I/O Module",
-		"Memory Module",
-		"Daughter Board",
-		"Motherboard",
-		"Processor+Memory Module",
-		"Processor+I/O Module",
-		"Interconnect Board" /* 0x0D */
-	};
-
-	if (code >= 0x01 && code <= 0x0D)
-		return type[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_base_board_type_enum, code);
 }
 
 static void dmi_base_board_handles(u8 count, const u8 *p)
@@ -596,53 +744,54 @@ static void dmi_base_board_handles(u8 count, const u8 *p)
  * 7.4 Chassis Information (Type 3)
  */
 
+/* 7.4.1 */
+static const char * const dmi_chassis_type_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"Desktop",
+	"Low Profile Desktop",
+	"Pizza Box",
+	"Mini Tower",
+	"Tower",
+	"Portable",
+	"Laptop",
+	"Notebook",
+	"Hand Held",
+	"Docking Station",
+	"All In One",
+	"Sub Notebook",
+	"Space-saving",
+	"Lunch Box",
+	"Main Server Chassis", /* CIM_Chassis.ChassisPackageType says "Main System Chassis" */
+	"Expansion Chassis",
+	"Sub Chassis",
+	"Bus Expansion Chassis",
+	"Peripheral Chassis",
+	"RAID Chassis",
+	"Rack Mount Chassis",
+	"Sealed-case PC",
+	"Multi-system",
+	"CompactPCI",
+	"AdvancedTCA",
+	"Blade",
+	"Blade Enclosing",
+	"Tablet",
+	"Convertible",
+	"Detachable",
+	"IoT Gateway",
+	"Embedded PC",
+	"Mini PC",
+	"Stick PC" /* 0x24 */
+};
+
+static const struct dmi_enum dmi_chassis_type_enum = {
+	0x7F, /* bits 6:0 are chassis type, 7th bit is the lock bit */
+	{ { 0x01, ARRAY_SIZE(dmi_chassis_type_names), dmi_chassis_type_names } }
+};
+
 static const char *dmi_chassis_type(u8 code)
 {
-	/* 7.4.1 */
-	static const char *type[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"Desktop",
-		"Low Profile Desktop",
-		"Pizza Box",
-		"Mini Tower",
-		"Tower",
-		"Portable",
-		"Laptop",
-		"Notebook",
-		"Hand Held",
-		"Docking Station",
-		"All In One",
-		"Sub Notebook",
-		"Space-saving",
-		"Lunch Box",
-		"Main Server Chassis", /* CIM_Chassis.ChassisPackageType says "Main System Chassis" */
-		"Expansion Chassis",
-		"Sub Chassis",
-		"Bus Expansion Chassis",
-		"Peripheral Chassis",
-		"RAID Chassis",
-		"Rack Mount Chassis",
-		"Sealed-case PC",
-		"Multi-system",
-		"CompactPCI",
-		"AdvancedTCA",
-		"Blade",
-		"Blade Enclosing",
-		"Tablet",
-		"Convertible",
-		"Detachable",
-		"IoT Gateway",
-		"Embedded PC",
-		"Mini PC",
-		"Stick PC" /* 0x24 */
-	};
-
-	code &= 0x7F; /* bits 6:0 are chassis type, 7th bit is the lock bit */
-
-	if (code >= 0x01 && code <= 0x24)
-		return type[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_chassis_type_enum, code);
 }
 
 static const char *dmi_chassis_lock(u8 code)
@@ -655,37 +804,41 @@ static const char *dmi_chassis_lock(u8 code)
 	return lock[code];
 }
 
+/* 7.4.2 */
+static const char * const dmi_chassis_state_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"Safe",
+	"Warning",
+	"Critical",
+	"Non-recoverable" /* 0x06 */
+};
+
+static const struct dmi_enum dmi_chassis_state_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_chassis_state_names), dmi_chassis_state_names } }
+};
+
 static const char *dmi_chassis_state(u8 code)
 {
-	/* 7.4.2 */
-	static const char *state[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"Safe",
-		"Warning",
-		"Critical",
-		"Non-recoverable" /* 0x06 */
-	};
-
-	if (code >= 0x01 && code <= 0x06)
-		return state[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_chassis_state_enum, code);
 }
 
+/* 7.4.3 */
+static const char * const dmi_chassis_security_status_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"None",
+	"External Interface Locked Out",
+	"External Interface Enabled" /* 0x05 */
+};
+
+static const struct dmi_enum dmi_chassis_security_status_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_chassis_security_status_names), dmi_chassis_security_status_names } }
+};
+
 static const char *dmi_chassis_security_status(u8 code)
 {
-	/* 7.4.3 */
-	static const char *status[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"None",
-		"External Interface Locked Out",
-		"External Interface Enabled" /* 0x05 */
-	};
-
-	if (code >= 0x01 && code <= 0x05)
-		return status[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_chassis_security_status_enum, code);
 }
 
 static void dmi_chassis_height(u8 code)
@@ -733,283 +886,281 @@ static void dmi_chassis_elements(u8 count, u8 len, const u8 *p)
  * 7.5 Processor Information (Type 4)
  */
 
+/* 7.5.1 */
+static const char * const dmi_processor_type_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"Central Processor",
+	"Math Processor",
+	"DSP Processor",
+	"Video Processor" /* 0x06 */
+};
+
+static const struct dmi_enum dmi_processor_type_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_processor_type_names), dmi_processor_type_names } }
+};
+
 static const char *dmi_processor_type(u8 code)
 {
-	/* 7.5.1 */
-	static const char *type[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"Central Processor",
-		"Math Processor",
-		"DSP Processor",
-		"Video Processor" /* 0x06 */
-	};
-
-	if (code >= 0x01 && code <= 0x06)
-		return type[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_processor_type_enum, code);
 }
 
 static const char *dmi_processor_family(const struct dmi_header *h, u16 ver)
 {
 	const u8 *data = h->data;
-	unsigned int i, low, high;
 	u16 code;
 
 	/* 7.5.2 */
-	static struct {
-		int value;
-		const char *name;
-	} family2[] = {
-		{ 0x01, "Other" },
-		{ 0x02, "Unknown" },
-		{ 0x03, "8086" },
-		{ 0x04, "80286" },
-		{ 0x05, "80386" },
-		{ 0x06, "80486" },
-		{ 0x07, "8087" },
-		{ 0x08, "80287" },
-		{ 0x09, "80387" },
-		{ 0x0A, "80487" },
-		{ 0x0B, "Pentium" },
-		{ 0x0C, "Pentium Pro" },
-		{ 0x0D, "Pentium II" },
-		{ 0x0E, "Pentium MMX" },
-		{ 0x0F, "Celeron" },
-		{ 0x10, "Pentium II Xeon" },
-		{ 0x11, "Pentium III" },
-		{ 0x12, "M1" },
-		{ 0x13, "M2" },
-		{ 0x14, "Celeron M" },
-		{ 0x15, "Pentium 4 HT" },
-		{ 0x16, "Intel" },
-
-		{ 0x18, "Duron" },
-		{ 0x19, "K5" },
-		{ 0x1A, "K6" },
-		{ 0x1B, "K6-2" },
-		{ 0x1C, "K6-3" },
-		{ 0x1D, "Athlon" },
-		{ 0x1E, "AMD29000" },
-		{ 0x1F, "K6-2+" },
-		{ 0x20, "Power PC" },
-		{ 0x21, "Power PC 601" },
-		{ 0x22, "Power PC 603" },
-		{ 0x23, "Power PC 603+" },
-		{ 0x24, "Power PC 604" },
-		{ 0x25, "Power PC 620" },
-		{ 0x26, "Power PC x704" },
-		{ 0x27, "Power PC 750" },
-		{ 0x28, "Core Duo" },
-		{ 0x29, "Core Duo Mobile" },
-		{ 0x2A, "Core Solo Mobile" },
-		{ 0x2B, "Atom" },
-		{ 0x2C, "Core M" },
-		{ 0x2D, "Core m3" },
-		{ 0x2E, "Core m5" },
-		{ 0x2F, "Core m7" },
-		{ 0x30, "Alpha" },
-		{ 0x31, "Alpha 21064" },
-		{ 0x32, "Alpha 21066" },
-		{ 0x33, "Alpha 21164" },
-		{ 0x34, "Alpha 21164PC" },
-		{ 0x35, "Alpha 21164a" },
-		{ 0x36, "Alpha 21264" },
-		{ 0x37, "Alpha 21364" },
-		{ 0x38, "Turion II Ultra Dual-Core Mobile M" },
-		{ 0x39, "Turion II Dual-Core Mobile M" },
-		{ 0x3A, "Athlon II Dual-Core M" },
-		{ 0x3B, "Opteron 6100" },
-		{ 0x3C, "Opteron 4100" },
-		{ 0x3D, "Opteron 6200" },
-		{ 0x3E, "Opteron 4200" },
-		{ 0x3F, "FX" },
-		{ 0x40, "MIPS" },
-		{ 0x41, "MIPS R4000" },
-		{ 0x42, "MIPS R4200" },
-		{ 0x43, "MIPS R4400" },
-		{ 0x44, "MIPS R4600" },
-		{ 0x45, "MIPS R10000" },
-		{ 0x46, "C-Series" },
-		{ 0x47, "E-Series" },
-		{ 0x48, "A-Series" },
-		{ 0x49, "G-Series" },
-		{ 0x4A, "Z-Series" },
-		{ 0x4B, "R-Series" },
-		{ 0x4C, "Opteron 4300" },
-		{ 0x4D, "Opteron 6300" },
-		{ 0x4E, "Opteron 3300" },
-		{ 0x4F, "FirePro" },
-		{ 0x50, "SPARC" },
-		{ 0x51, "SuperSPARC" },
-		{ 0x52, "MicroSPARC II" },
-		{ 0x53, "MicroSPARC IIep" },
-		{ 0x54, "UltraSPARC" },
-		{ 0x55, "UltraSPARC II" },
-		{ 0x56, "UltraSPARC IIi" },
-		{ 0x57, "UltraSPARC III" },
-		{ 0x58, "UltraSPARC IIIi" },
-
-		{ 0x60, "68040" },
-		{ 0x61, "68xxx" },
-		{ 0x62, "68000" },
-		{ 0x63, "68010" },
-		{ 0x64, "68020" },
-		{ 0x65, "68030" },
-		{ 0x66, "Athlon X4" },
-		{ 0x67, "Opteron X1000" },
-		{ 0x68, "Opteron X2000" },
-		{ 0x69, "Opteron A-Series" },
-		{ 0x6A, "Opteron X3000" },
-		{ 0x6B, "Zen" },
-
-		{ 0x70, "Hobbit" },
-
-		{ 0x78, "Crusoe TM5000" },
-		{ 0x79, "Crusoe TM3000" },
-		{ 0x7A, "Efficeon TM8000" },
-
-		{ 0x80, "Weitek" },
-
-		{ 0x82, "Itanium" },
-		{ 0x83, "Athlon 64" },
-		{ 0x84, "Opteron" },
-		{ 0x85, "Sempron" },
-		{ 0x86, "Turion 64" },
-		{ 0x87, "Dual-Core Opteron" },
-		{ 0x88, "Athlon 64 X2" },
-		{ 0x89, "Turion 64 X2" },
-		{ 0x8A, "Quad-Core Opteron" },
-		{ 0x8B, "Third-Generation Opteron" },
-		{ 0x8C, "Phenom FX" },
-		{ 0x8D, "Phenom X4" },
-		{ 0x8E, "Phenom X2" },
-		{ 0x8F, "Athlon X2" },
-		{ 0x90, "PA-RISC" },
-		{ 0x91, "PA-RISC 8500" },
-		{ 0x92, "PA-RISC 8000" },
-		{ 0x93, "PA-RISC 7300LC" },
-		{ 0x94, "PA-RISC 7200" },
-		{ 0x95, "PA-RISC 7100LC" },
-		{ 0x96, "PA-RISC 7100" },
-
-		{ 0xA0, "V30" },
-		{ 0xA1, "Quad-Core Xeon 3200" },
-		{ 0xA2, "Dual-Core Xeon 3000" },
-		{ 0xA3, "Quad-Core Xeon 5300" },
-		{ 0xA4, "Dual-Core Xeon 5100" },
-		{ 0xA5, "Dual-Core Xeon 5000" },
-		{ 0xA6, "Dual-Core Xeon LV" },
-		{ 0xA7, "Dual-Core Xeon ULV" },
-		{ 0xA8, "Dual-Core Xeon 7100" },
-		{ 0xA9, "Quad-Core Xeon 5400" },
-		{ 0xAA, "Quad-Core Xeon" },
-		{ 0xAB, "Dual-Core Xeon 5200" },
-		{ 0xAC, "Dual-Core Xeon 7200" },
-		{ 0xAD, "Quad-Core Xeon 7300" },
-		{ 0xAE, "Quad-Core Xeon 7400" },
-		{ 0xAF, "Multi-Core Xeon 7400" },
-		{ 0xB0, "Pentium III Xeon" },
-		{ 0xB1, "Pentium III Speedstep" },
-		{ 0xB2, "Pentium 4" },
-		{ 0xB3, "Xeon" },
-		{ 0xB4, "AS400" },
-		{ 0xB5, "Xeon MP" },
-		{ 0xB6, "Athlon XP" },
-		{ 0xB7, "Athlon MP" },
-		{ 0xB8, "Itanium 2" },
-		{ 0xB9, "Pentium M" },
-		{ 0xBA, "Celeron D" },
-		{ 0xBB, "Pentium D" },
-		{ 0xBC, "Pentium EE" },
-		{ 0xBD, "Core Solo" },
+	static const char * const family2[] = {
+		[0x01] = "Other",
+		[0x02] = "Unknown",
+		[0x03] = "8086",
+		[0x04] = "80286",
+		[0x05] = "80386",
+		[0x06] = "80486",
+		[0x07] = "8087",
+		[0x08] = "80287",
+		[0x09] = "80387",
+		[0x0A] = "80487",
+		[0x0B] = "Pentium",
+		[0x0C] = "Pentium Pro",
+		[0x0D] = "Pentium II",
+		[0x0E] = "Pentium MMX",
+		[0x0F] = "Celeron",
+		[0x10] = "Pentium II Xeon",
+		[0x11] = "Pentium III",
+		[0x12] = "M1",
+		[0x13] = "M2",
+		[0x14] = "Celeron M",
+		[0x15] = "Pentium 4 HT",
+		[0x16] = "Intel",
+
+		[0x18] = "Duron",
+		[0x19] = "K5",
+		[0x1A] = "K6",
+		[0x1B] = "K6-2",
+		[0x1C] = "K6-3",
+		[0x1D] = "Athlon",
+		[0x1E] = "AMD29000",
+		[0x1F] = "K6-2+",
+		[0x20] = "Power PC",
+		[0x21] = "Power PC 601",
+		[0x22] = "Power PC 603",
+		[0x23] = "Power PC 603+",
+		[0x24] = "Power PC 604",
+		[0x25] = "Power PC 620",
+		[0x26] = "Power PC x704",
+		[0x27] = "Power PC 750",
+		[0x28] = "Core Duo",
+		[0x29] = "Core Duo Mobile",
+		[0x2A] = "Core Solo Mobile",
+		[0x2B] = "Atom",
+		[0x2C] = "Core M",
+		[0x2D] = "Core m3",
+		[0x2E] = "Core m5",
+		[0x2F] = "Core m7",
+		[0x30] = "Alpha",
+		[0x31] = "Alpha 21064",
+		[0x32] = "Alpha 21066",
+		[0x33] = "Alpha 21164",
+		[0x34] = "Alpha 21164PC",
+		[0x35] = "Alpha 21164a",
+		[0x36] = "Alpha 21264",
+		[0x37] = "Alpha 21364",
+		[0x38] = "Turion II Ultra Dual-Core Mobile M",
+		[0x39] = "Turion II Dual-Core Mobile M",
+		[0x3A] = "Athlon II Dual-Core M",
+		[0x3B] = "Opteron 6100",
+		[0x3C] = "Opteron 4100",
+		[0x3D] = "Opteron 6200",
+		[0x3E] = "Opteron 4200",
+		[0x3F] = "FX",
+		[0x40] = "MIPS",
+		[0x41] = "MIPS R4000",
+		[0x42] = "MIPS R4200",
+		[0x43] = "MIPS R4400",
+		[0x44] = "MIPS R4600",
+		[0x45] = "MIPS R10000",
+		[0x46] = "C-Series",
+		[0x47] = "E-Series",
+		[0x48] = "A-Series",
+		[0x49] = "G-Series",
+		[0x4A] = "Z-Series",
+		[0x4B] = "R-Series",
+		[0x4C] = "Opteron 4300",
+		[0x4D] = "Opteron 6300",
+		[0x4E] = "Opteron 3300",
+		[0x4F] = "FirePro",
+		[0x50] = "SPARC",
+		[0x51] = "SuperSPARC",
+		[0x52] = "MicroSPARC II",
+		[0x53] = "MicroSPARC IIep",
+		[0x54] = "UltraSPARC",
+		[0x55] = "UltraSPARC II",
+		[0x56] = "UltraSPARC IIi",
+		[0x57] = "UltraSPARC III",
+		[0x58] = "UltraSPARC IIIi",
+
+		[0x60] = "68040",
+		[0x61] = "68xxx",
+		[0x62] = "68000",
+		[0x63] = "68010",
+		[0x64] = "68020",
+		[0x65] = "68030",
+		[0x66] = "Athlon X4",
+		[0x67] = "Opteron X1000",
+		[0x68] = "Opteron X2000",
+		[0x69] = "Opteron A-Series",
+		[0x6A] = "Opteron X3000",
+		[0x6B] = "Zen",
+
+		[0x70] = "Hobbit",
+
+		[0x78] = "Crusoe TM5000",
+		[0x79] = "Crusoe TM3000",
+		[0x7A] = "Efficeon TM8000",
+
+		[0x80] = "Weitek",
+
+		[0x82] = "Itanium",
+		[0x83] = "Athlon 64",
+		[0x84] = "Opteron",
+		[0x85] = "Sempron",
+		[0x86] = "Turion 64",
+		[0x87] = "Dual-Core Opteron",
+		[0x88] = "Athlon 64 X2",
+		[0x89] = "Turion 64 X2",
+		[0x8A] = "Quad-Core Opteron",
+		[0x8B] = "Third-Generation Opteron",
+		[0x8C] = "Phenom FX",
+		[0x8D] = "Phenom X4",
+		[0x8E] = "Phenom X2",
+		[0x8F] = "Athlon X2",
+		[0x90] = "PA-RISC",
+		[0x91] = "PA-RISC 8500",
+		[0x92] = "PA-RISC 8000",
+		[0x93] = "PA-RISC 7300LC",
+		[0x94] = "PA-RISC 7200",
+		[0x95] = "PA-RISC 7100LC",
+		[0x96] = "PA-RISC 7100",
+
+		[0xA0] = "V30",
+		[0xA1] = "Quad-Core Xeon 3200",
+		[0xA2] = "Dual-Core Xeon 3000",
+		[0xA3] = "Quad-Core Xeon 5300",
+		[0xA4] = "Dual-Core Xeon 5100",
+		[0xA5] = "Dual-Core Xeon 5000",
+		[0xA6] = "Dual-Core Xeon LV",
+		[0xA7] = "Dual-Core Xeon ULV",
+		[0xA8] = "Dual-Core Xeon 7100",
+		[0xA9] = "Quad-Core Xeon 5400",
+		[0xAA] = "Quad-Core Xeon",
+		[0xAB] = "Dual-Core Xeon 5200",
+		[0xAC] = "Dual-Core Xeon 7200",
+		[0xAD] = "Quad-Core Xeon 7300",
+		[0xAE] = "Quad-Core Xeon 7400",
+		[0xAF] = "Multi-Core Xeon 7400",
+		[0xB0] = "Pentium III Xeon",
+		[0xB1] = "Pentium III Speedstep",
+		[0xB2] = "Pentium 4",
+		[0xB3] = "Xeon",
+		[0xB4] = "AS400",
+		[0xB5] = "Xeon MP",
+		[0xB6] = "Athlon XP",
+		[0xB7] = "Athlon MP",
+		[0xB8] = "Itanium 2",
+		[0xB9] = "Pentium M",
+		[0xBA] = "Celeron D",
+		[0xBB] = "Pentium D",
+		[0xBC] = "Pentium EE",
+		[0xBD] = "Core Solo",
 		/* 0xBE handled as a special case */
-		{ 0xBF, "Core 2 Duo" },
-		{ 0xC0, "Core 2 Solo" },
-		{ 0xC1, "Core 2 Extreme" },
-		{ 0xC2, "Core 2 Quad" },
-		{ 0xC3, "Core 2 Extreme Mobile" },
-		{ 0xC4, "Core 2 Duo Mobile" },
-		{ 0xC5, "Core 2 Solo Mobile" },
-		{ 0xC6, "Core i7" },
-		{ 0xC7, "Dual-Core Celeron" },
-		{ 0xC8, "IBM390" },
-		{ 0xC9, "G4" },
-		{ 0xCA, "G5" },
-		{ 0xCB, "ESA/390 G6" },
-		{ 0xCC, "z/Architecture" },
-		{ 0xCD, "Core i5" },
-		{ 0xCE, "Core i3" },
-		{ 0xCF, "Core i9" },
-
-		{ 0xD2, "C7-M" },
-		{ 0xD3, "C7-D" },
-		{ 0xD4, "C7" },
-		{ 0xD5, "Eden" },
-		{ 0xD6, "Multi-Core Xeon" },
-		{ 0xD7, "Dual-Core Xeon 3xxx" },
-		{ 0xD8, "Quad-Core Xeon 3xxx" },
-		{ 0xD9, "Nano" },
-		{ 0xDA, "Dual-Core Xeon 5xxx" },
-		{ 0xDB, "Quad-Core Xeon 5xxx" },
-
-		{ 0xDD, "Dual-Core Xeon 7xxx" },
-		{ 0xDE, "Quad-Core Xeon 7xxx" },
-		{ 0xDF, "Multi-Core Xeon 7xxx" },
-		{ 0xE0, "Multi-Core Xeon 3400" },
-
-		{ 0xE4, "Opteron 3000" },
-		{ 0xE5, "Sempron II" },
-		{ 0xE6, "Embedded Opteron Quad-Core" },
-		{ 0xE7, "Phenom Triple-Core" },
-		{ 0xE8, "Turion Ultra Dual-Core Mobile" },
-		{ 0xE9, "Turion Dual-Core Mobile" },
-		{ 0xEA, "Athlon Dual-Core" },
-		{ 0xEB, "Sempron SI" },
-		{ 0xEC, "Phenom II" },
-		{ 0xED, "Athlon II" },
-		{ 0xEE, "Six-Core Opteron" },
-		{ 0xEF, "Sempron M" },
-
-		{ 0xFA, "i860" },
-		{ 0xFB, "i960" },
-
-		{ 0x100, "ARMv7" },
-		{ 0x101, "ARMv8" },
-		{ 0x102, "ARMv9" },
-		{ 0x103, "ARM" },
-		{ 0x104, "SH-3" },
-		{ 0x105, "SH-4" },
-		{ 0x118, "ARM" },
-		{ 0x119, "StrongARM" },
-		{ 0x12C, "6x86" },
-		{ 0x12D, "MediaGX" },
-		{ 0x12E, "MII" },
-		{ 0x140, "WinChip" },
-		{ 0x15E, "DSP" },
-		{ 0x1F4, "Video Processor" },
-
-		{ 0x200, "RV32" },
-		{ 0x201, "RV64" },
-		{ 0x202, "RV128" },
-
-		{ 0x258, "LoongArch" },
-		{ 0x259, "Loongson 1" },
-		{ 0x25A, "Loongson 2" },
-		{ 0x25B, "Loongson 3" },
-		{ 0x25C, "Loongson 2K" },
-		{ 0x25D, "Loongson 3A" },
-		{ 0x25E, "Loongson 3B" },
-		{ 0x25F, "Loongson 3C" },
-		{ 0x260, "Loongson 3D" },
-		{ 0x261, "Loongson 3E" },
-		{ 0x262, "Dual-Core Loongson 2K 2xxx" },
-		{ 0x26C, "Quad-Core Loongson 3A 5xxx" },
-		{ 0x26D, "Multi-Core Loongson 3A 5xxx" },
-		{ 0x26E, "Quad-Core Loongson 3B 5xxx" },
-		{ 0x26F, "Multi-Core Loongson 3B 5xxx" },
-		{ 0x270, "Multi-Core Loongson 3C 5xxx" },
-		{ 0x271, "Multi-Core Loongson 3D 5xxx" },
+		[0xBF] = "Core 2 Duo",
+		[0xC0] = "Core 2 Solo",
+		[0xC1] = "Core 2 Extreme",
+		[0xC2] = "Core 2 Quad",
+		[0xC3] = "Core 2 Extreme Mobile",
+		[0xC4] = "Core 2 Duo Mobile",
+		[0xC5] = "Core 2 Solo Mobile",
+		[0xC6] = "Core i7",
+		[0xC7] = "Dual-Core Celeron",
+		[0xC8] = "IBM390",
+		[0xC9] = "G4",
+		[0xCA] = "G5",
+		[0xCB] = "ESA/390 G6",
+		[0xCC] = "z/Architecture",
+		[0xCD] = "Core i5",
+		[0xCE] = "Core i3",
+		[0xCF] = "Core i9",
+
+		[0xD2] = "C7-M",
+		[0xD3] = "C7-D",
+		[0xD4] = "C7",
+		[0xD5] = "Eden",
+		[0xD6] = "Multi-Core Xeon",
+		[0xD7] = "Dual-Core Xeon 3xxx",
+		[0xD8] = "Quad-Core Xeon 3xxx",
+		[0xD9] = "Nano",
+		[0xDA] = "Dual-Core Xeon 5xxx",
+		[0xDB] = "Quad-Core Xeon 5xxx",
+
+		[0xDD] = "Dual-Core Xeon 7xxx",
+		[0xDE] = "Quad-Core Xeon 7xxx",
+		[0xDF] = "Multi-Core Xeon 7xxx",
+		[0xE0] = "Multi-Core Xeon 3400",
+
+		[0xE4] = "Opteron 3000",
+		[0xE5] = "Sempron II",
+		[0xE6] = "Embedded Opteron Quad-Core",
+		[0xE7] = "Phenom Triple-Core",
+		[0xE8] = "Turion Ultra Dual-Core Mobile",
+		[0xE9] = "Turion Dual-Core Mobile",
+		[0xEA] = "Athlon Dual-Core",
+		[0xEB] = "Sempron SI",
+		[0xEC] = "Phenom II",
+		[0xED] = "Athlon II",
+		[0xEE] = "Six-Core Opteron",
+		[0xEF] = "Sempron M",
+
+		[0xFA] = "i860",
+		[0xFB] = "i960",
+
+		[0x100] = "ARMv7",
+		[0x101] = "ARMv8",
+		[0x102] = "ARMv9",
+		[0x103] = "ARM",
+		[0x104] = "SH-3",
+		[0x105] = "SH-4",
+		[0x118] = "ARM",
+		[0x119] = "StrongARM",
+		[0x12C] = "6x86",
+		[0x12D] = "MediaGX",
+		[0x12E] = "MII",
+		[0x140] = "WinChip",
+		[0x15E] = "DSP",
+		[0x1F4] = "Video Processor",
+
+		[0x200] = "RV32",
+		[0x201] = "RV64",
+		[0x202] = "RV128",
+
+		[0x258] = "LoongArch",
+		[0x259] = "Loongson 1",
+		[0x25A] = "Loongson 2",
+		[0x25B] = "Loongson 3",
+		[0x25C] = "Loongson 2K",
+		[0x25D] = "Loongson 3A",
+		[0x25E] = "Loongson 3B",
+		[0x25F] = "Loongson 3C",
+		[0x260] = "Loongson 3D",
+		[0x261] = "Loongson 3E",
+		[0x262] = "Dual-Core Loongson 2K 2xxx",
+		[0x26C] = "Quad-Core Loongson 3A 5xxx",
+		[0x26D] = "Multi-Core Loongson 3A 5xxx",
+		[0x26E] = "Quad-Core Loongson 3B 5xxx",
+		[0x26F] = "Multi-Core Loongson 3B 5xxx",
+		[0x270] = "Multi-Core Loongson 3C 5xxx",
+		[0x271] = "Multi-Core Loongson 3D 5xxx",
 	};
 	/*
 	 * Note to developers: when adding entries to this list, check if
@@ -1048,23 +1199,10 @@ static const char *dmi_processor_family(const struct dmi_header *h, u16 ver)
 		return "Core 2 or K7";
 	}
 
-	/* Perform a binary search */
-	low = 0;
-	high = ARRAY_SIZE(family2) - 1;
-
-	while (1)
-	{
-		i = (low + high) / 2;
-		if (family2[i].value == code)
-			return family2[i].name;
-		if (low == high) /* Not found */
-			return out_of_spec;
-
-		if (code < family2[i].value)
-			high = i;
-		else
-			low = i + 1;
-	}
+	/* Table is indexed by code, unassigned entries are NULL */
+	if (code < ARRAY_SIZE(family2) && family2[code] != NULL)
+		return family2[code];
+	return out_of_spec;
 }
 
 static enum cpuid_type dmi_get_cpuid_type(const struct dmi_header *h)
@@ -1241,7 +1379,7 @@ void dmi_print_cpuid(void (*print_cb)(const char *name, const char *format, ...)
 static void dmi_processor_id(const struct dmi_header *h)
 {
 	/* Intel AP-485 revision 36, table 2-4 */
-	static const char *flags[32] = {
+	static const char * const flags[32] = {
 		"FPU (Floating-point unit on-chip)", /* 0 */
 		"VME (Virtual mode extension)",
 		"DE (Debugging extension)",
@@ -1275,6 +1413,9 @@ static void dmi_processor_id(const struct dmi_header *h)
 		NULL, /* 30 */
 		"PBE (Pending break enabled)" /* 31 */
 	};
+	static const struct dmi_bitfield bits = {
+		0, ARRAY_SIZE(flags), flags
+	};
 	const u8 *data = h->data;
 	const u8 *p = data + 0x08;
 	enum cpuid_type sig = dmi_get_cpuid_type(h);
@@ -1298,12 +1439,8 @@ static void dmi_processor_id(const struct dmi_header *h)
 		pr_list_start("Flags", "None");
 	else
 	{
-		int i;
-
 		pr_list_start("Flags", NULL);
-		for (i = 0; i <= 31; i++)
-			if (flags[i] != NULL && edx & (1 << i))
-				pr_list_item("%s", flags[i]);
+		dmi_bitfield_list(&bits, edx);
 	}
 	pr_list_end();
 }
@@ -1311,12 +1448,14 @@ static void dmi_processor_id(const struct dmi_header *h)
 static void dmi_processor_voltage(const char *attr, u8 code)
 {
 	/* 7.5.4 */
-	static const char *voltage[] = {
+	static const char * const voltage[] = {
 		"5.0 V", /* 0 */
 		"3.3 V",
 		"2.9 V" /* 2 */
 	};
-	int i;
+	static const struct dmi_bitfield bits = {
+		0, ARRAY_SIZE(voltage), voltage
+	};
 
 	if (code & 0x80)
 		pr_attr(attr, "%.1f V", (float)(code & 0x7f) / 10);
@@ -1325,20 +1464,10 @@ static void dmi_processor_voltage(const char *attr, u8 code)
 	else
 	{
 		char voltage_str[18];
-		int off = 0;
 
-		for (i = 0; i <= 2; i++)
-		{
-			if (code & (1 << i))
-			{
-				/* Insert space if not the first value */
-				off += sprintf(voltage_str + off,
-					       off ? " %s" :"%s",
-					       voltage[i]);
-			}
-		}
-		if (off)
-			pr_attr(attr, voltage_str);
+		if (dmi_bitfield_join(&bits, code, voltage_str,
+				      sizeof(voltage_str)))
+			pr_attr(attr, "%s", voltage_str);
 	}
 }
 
@@ -1379,95 +1508,97 @@ static const char *dmi_processor_status(u8 code)
 	return status[code];
 }
 
+/* 7.5.5 */
+static const char * const dmi_processor_upgrade_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"Daughter Board",
+	"ZIF Socket",
+	"Replaceable Piggy Back",
+	"None",
+	"LIF Socket",
+	"Slot 1",
+	"Slot 2",
+	"370-pin Socket",
+	"Slot A",
+	"Slot M",
+	"Socket 423",
+	"Socket A (Socket 462)",
+	"Socket 478",
+	"Socket 754",
+	"Socket 940",
+	"Socket 939",
+	"Socket mPGA604",
+	"Socket LGA771",
+	"Socket LGA775",
+	"Socket S1",
+	"Socket AM2",
+	"Socket F (1207)",
+	"Socket LGA1366",
+	"Socket G34",
+	"Socket AM3",
+	"Socket C32",
+	"Socket LGA1156",
+	"Socket LGA1567",
+	"Socket PGA988A",
+	"Socket BGA1288",
+	"Socket rPGA988B",
+	"Socket BGA1023",
+	"Socket BGA1224",
+	"Socket BGA1155",
+	"Socket LGA1356",
+	"Socket LGA2011",
+	"Socket FS1",
+	"Socket FS2",
+	"Socket FM1",
+	"Socket FM2",
+	"Socket LGA2011-3",
+	"Socket LGA1356-3",
+	"Socket LGA1150",
+	"Socket BGA1168",
+	"Socket BGA1234",
+	"Socket BGA1364",
+	"Socket AM4",
+	"Socket LGA1151",
+	"Socket BGA1356",
+	"Socket BGA1440",
+	"Socket BGA1515",
+	"Socket LGA3647-1",
+	"Socket SP3",
+	"Socket SP3r2",
+	"Socket LGA2066",
+	"Socket BGA1392",
+	"Socket BGA1510",
+	"Socket BGA1528",
+	"Socket LGA4189",
+	"Socket LGA1200",
+	"Socket LGA4677",
+	"Socket LGA1700",
+	"Socket BGA1744",
+	"Socket BGA1781",
+	"Socket BGA1211",
+	"Socket BGA2422",
+	"Socket LGA1211",
+	"Socket LGA2422",
+	"Socket LGA5773",
+	"Socket BGA5773",
+	"Socket AM5",
+	"Socket SP5",
+	"Socket SP6",
+	"Socket BGA883",
+	"Socket BGA1190",
+	"Socket BGA4129",
+	"Socket LGA4710",
+	"Socket LGA7529" /* 0x50 */
+};
+
+static const struct dmi_enum dmi_processor_upgrade_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_processor_upgrade_names), dmi_processor_upgrade_names } }
+};
+
 static const char *dmi_processor_upgrade(u8 code)
 {
-	/* 7.5.5 */
-	static const char *upgrade[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"Daughter Board",
-		"ZIF Socket",
-		"Replaceable Piggy Back",
-		"None",
-		"LIF Socket",
-		"Slot 1",
-		"Slot 2",
-		"370-pin Socket",
-		"Slot A",
-		"Slot M",
-		"Socket 423",
-		"Socket A (Socket 462)",
-		"Socket 478",
-		"Socket 754",
-		"Socket 940",
-		"Socket 939",
-		"Socket mPGA604",
-		"Socket LGA771",
-		"Socket LGA775",
-		"Socket S1",
-		"Socket AM2",
-		"Socket F (1207)",
-		"Socket LGA1366",
-		"Socket G34",
-		"Socket AM3",
-		"Socket C32",
-		"Socket LGA1156",
-		"Socket LGA1567",
-		"Socket PGA988A",
-		"Socket BGA1288",
-		"Socket rPGA988B",
-		"Socket BGA1023",
-		"Socket BGA1224",
-		"Socket BGA1155",
-		"Socket LGA1356",
-		"Socket LGA2011",
-		"Socket FS1",
-		"Socket FS2",
-		"Socket FM1",
-		"Socket FM2",
-		"Socket LGA2011-3",
-		"Socket LGA1356-3",
-		"Socket LGA1150",
-		"Socket BGA1168",
-		"Socket BGA1234",
-		"Socket BGA1364",
-		"Socket AM4",
-		"Socket LGA1151",
-		"Socket BGA1356",
-		"Socket BGA1440",
-		"Socket BGA1515",
-		"Socket LGA3647-1",
-		"Socket SP3",
-		"Socket SP3r2",
-		"Socket LGA2066",
-		"Socket BGA1392",
-		"Socket BGA1510",
-		"Socket BGA1528",
-		"Socket LGA4189",
-		"Socket LGA1200",
-		"Socket LGA4677",
-		"Socket LGA1700",
-		"Socket BGA1744",
-		"Socket BGA1781",
-		"Socket BGA1211",
-		"Socket BGA2422",
-		"Socket LGA1211",
-		"Socket LGA2422",
-		"Socket LGA5773",
-		"Socket BGA5773",
-		"Socket AM5",
-		"Socket SP5",
-		"Socket SP6",
-		"Socket BGA883",
-		"Socket BGA1190",
-		"Socket BGA4129",
-		"Socket LGA4710",
-		"Socket LGA7529" /* 0x50 */
-	};
-
-	if (code >= 0x01 && code <= 0x50)
-		return upgrade[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_processor_upgrade_enum, code);
 }
 
 static void dmi_processor_cache(const char *attr, u16 code, const char *level,
@@ -1487,7 +1618,7 @@ static void dmi_processor_cache(const char *attr, u16 code, const char *level,
 static void dmi_processor_characteristics(const char *attr, u16 code)
 {
 	/* 7.5.9 */
-	static const char *characteristics[] = {
+	static const char * const characteristics[] = {
 		"64-bit capable", /* 2 */
 		"Multi-Core",
 		"Hardware Thread",
@@ -1497,17 +1628,16 @@ static void dmi_processor_characteristics(const char *attr, u16 code)
 		"128-bit Capable",
 		"Arm64 SoC ID" /* 9 */
 	};
+	static const struct dmi_bitfield bits = {
+		2, ARRAY_SIZE(characteristics), characteristics
+	};
 
 	if ((code & 0x00FC) == 0)
 		pr_attr(attr, "None");
 	else
 	{
-		int i;
-
 		pr_list_start(attr, NULL);
-		for (i = 2; i <= 9; i++)
-			if (code & (1 << i))
-				pr_list_item("%s", characteristics[i - 2]);
+		dmi_bitfield_list(&bits, code);
 		pr_list_end();
 	}
 }
@@ -1538,7 +1668,7 @@ static const char *dmi_memory_controller_ed_method(u8 code)
 static void dmi_memory_controller_ec_capabilities(const char *attr, u8 code)
 {
 	/* 7.6.2 */
-	static const char *capabilities[] = {
+	static const char * const capabilities[] = {
 		"Other", /* 0 */
 		"Unknown",
 		"None",
@@ -1546,17 +1676,16 @@ static void dmi_memory_controller_ec_capabilities(const char *attr, u8 code)
 		"Double-bit Error Correcting",
 		"Error Scrubbing" /* 5 */
 	};
+	static const struct dmi_bitfield bits = {
+		0, ARRAY_SIZE(capabilities), capabilities
+	};
 
 	if ((code & 0x3F) == 0)
 		pr_attr(attr, "None");
 	else
 	{
-		int i;
-
 		pr_list_start(attr, NULL);
-		for (i = 0; i <= 5; i++)
-			if (code & (1 << i))
-				pr_list_item("%s", capabilities[i]);
+		dmi_bitfield_list(&bits, code);
 		pr_list_end();
 	}
 }
@@ -1582,24 +1711,23 @@ static const char *dmi_memory_controller_interleave(u8 code)
 static void dmi_memory_controller_speeds(const char *attr, u16 code)
 {
 	/* 7.6.4 */
-	const char *speeds[] = {
+	static const char * const speeds[] = {
 		"Other", /* 0 */
 		"Unknown",
 		"70 ns",
 		"60 ns",
 		"50 ns" /* 4 */
 	};
+	static const struct dmi_bitfield bits = {
+		0, ARRAY_SIZE(speeds), speeds
+	};
 
 	if ((code & 0x001F) == 0)
 		pr_attr(attr, "None");
 	else
 	{
-		int i;
-
 		pr_list_start(attr, NULL);
-		for (i = 0; i <= 4; i++)
-			if (code & (1 << i))
-				pr_list_item("%s", speeds[i]);
+		dmi_bitfield_list(&bits, code);
 		pr_list_end();
 	}
 }
@@ -1621,7 +1749,7 @@ static void dmi_memory_controller_slots(u8 count, const u8 *p)
 static void dmi_memory_module_types(const char *attr, u16 code, int flat)
 {
 	/* 7.7.1 */
-	static const char *types[] = {
+	static const char * const types[] = {
 		"Other", /* 0 */
 		"Unknown",
 		"Standard",
@@ -1634,35 +1762,23 @@ static void dmi_memory_module_types(const char *attr, u16 code, int flat)
 		"Burst EDO",
 		"SDRAM" /* 10 */
 	};
+	static const struct dmi_bitfield bits = {
+		0, ARRAY_SIZE(types), types
+	};
 
 	if ((code & 0x07FF) == 0)
 		pr_attr(attr, "None");
 	else if (flat)
 	{
 		char type_str[68];
-		int i, off = 0;
 
-		for (i = 0; i <= 10; i++)
-		{
-			if (code & (1 << i))
-			{
-				/* Insert space if not the first value */
-				off += sprintf(type_str + off,
-					       off ? " %s" :"%s",
-					       types[i]);
-			}
-		}
-		if (off)
-			pr_attr(attr, type_str);
+		if (dmi_bitfield_join(&bits, code, type_str, sizeof(type_str)))
+			pr_attr(attr, "%s", type_str);
 	}
 	else
 	{
-		int i;
-
 		pr_list_start(attr, NULL);
-		for (i = 0; i <= 10; i++)
-			if (code & (1 << i))
-				pr_list_item("%s", types[i]);
+		dmi_bitfield_list(&bits, code);
 		pr_list_end();
 	}
 }
@@ -1758,21 +1874,21 @@ static const char *dmi_cache_location(u8 code)
 	return location[code];
 }
 
+/* Returns the cache size in kB, code is in the Cache Size 2 format */
+unsigned long long dmi_cache_size_2_kb(u32 code)
+{
+	if (code & 0x80000000)
+		return (unsigned long long)(code & 0x7FFFFFFFLU) << 6;
+	return code;
+}
+
 static void dmi_cache_size_2(const char *attr, u32 code)
 {
+	unsigned long long kb = dmi_cache_size_2_kb(code);
 	u64 size;
 
-	if (code & 0x80000000)
-	{
-		code &= 0x7FFFFFFFLU;
-		size.l = code << 6;
-		size.h = code >> 26;
-	}
-	else
-	{
-		size.l = code;
-		size.h = 0;
-	}
+	size.l = kb;
+	size.h = kb >> 32;
 
 	/* Use a more convenient unit for large cache size */
 	dmi_print_memory_size(attr, size, 1);
@@ -1787,7 +1903,7 @@ static void dmi_cache_size(const char *attr, u16 code)
 static void dmi_cache_types(const char *attr, u16 code, int flat)
 {
 	/* 7.8.2 */
-	static const char *types[] = {
+	static const char * const types[] = {
 		"Other", /* 0 */
 		"Unknown",
 		"Non-burst",
@@ -1796,95 +1912,89 @@ static void dmi_cache_types(const char *attr, u16 code, int flat)
 		"Synchronous",
 		"Asynchronous" /* 6 */
 	};
+	static const struct dmi_bitfield bits = {
+		0, ARRAY_SIZE(types), types
+	};
 
 	if ((code & 0x007F) == 0)
 		pr_attr(attr, "None");
 	else if (flat)
 	{
 		char type_str[70];
-		int i, off = 0;
 
-		for (i = 0; i <= 6; i++)
-		{
-			if (code & (1 << i))
-			{
-				/* Insert space if not the first value */
-				off += sprintf(type_str + off,
-					       off ? " %s" :"%s",
-					       types[i]);
-			}
-		}
-		if (off)
-			pr_attr(attr, type_str);
+		if (dmi_bitfield_join(&bits, code, type_str, sizeof(type_str)))
+			pr_attr(attr, "%s", type_str);
 	}
 	else
 	{
-		int i;
-
 		pr_list_start(attr, NULL);
-		for (i = 0; i <= 6; i++)
-			if (code & (1 << i))
-				pr_list_item("%s", types[i]);
+		dmi_bitfield_list(&bits, code);
 		pr_list_end();
 	}
 }
 
+/* 7.8.3 */
+static const char * const dmi_cache_ec_type_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"None",
+	"Parity",
+	"Single-bit ECC",
+	"Multi-bit ECC" /* 0x06 */
+};
+
+static const struct dmi_enum dmi_cache_ec_type_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_cache_ec_type_names), dmi_cache_ec_type_names } }
+};
+
 static const char *dmi_cache_ec_type(u8 code)
 {
-	/* 7.8.3 */
-	static const char *type[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"None",
-		"Parity",
-		"Single-bit ECC",
-		"Multi-bit ECC" /* 0x06 */
-	};
-
-	if (code >= 0x01 && code <= 0x06)
-		return type[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_cache_ec_type_enum, code);
 }
 
+/* 7.8.4 */
+static const char * const dmi_cache_type_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"Instruction",
+	"Data",
+	"Unified" /* 0x05 */
+};
+
+static const struct dmi_enum dmi_cache_type_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_cache_type_names), dmi_cache_type_names } }
+};
+
 static const char *dmi_cache_type(u8 code)
 {
-	/* 7.8.4 */
-	static const char *type[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"Instruction",
-		"Data",
-		"Unified" /* 0x05 */
-	};
-
-	if (code >= 0x01 && code <= 0x05)
-		return type[code - 0x01];
-	return out_of_spec;
-}
+	return dmi_enum_name(&dmi_cache_type_enum, code);
+}
+
+/* 7.8.5 */
+static const char * const dmi_cache_associativity_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"Direct Mapped",
+	"2-way Set-associative",
+	"4-way Set-associative",
+	"Fully Associative",
+	"8-way Set-associative",
+	"16-way Set-associative",
+	"12-way Set-associative",
+	"24-way Set-associative",
+	"32-way Set-associative",
+	"48-way Set-associative",
+	"64-way Set-associative",
+	"20-way Set-associative" /* 0x0E */
+};
+
+static const struct dmi_enum dmi_cache_associativity_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_cache_associativity_names), dmi_cache_associativity_names } }
+};
 
 static const char *dmi_cache_associativity(u8 code)
 {
-	/* 7.8.5 */
-	static const char *type[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"Direct Mapped",
-		"2-way Set-associative",
-		"4-way Set-associative",
-		"Fully Associative",
-		"8-way Set-associative",
-		"16-way Set-associative",
-		"12-way Set-associative",
-		"24-way Set-associative",
-		"32-way Set-associative",
-		"48-way Set-associative",
-		"64-way Set-associative",
-		"20-way Set-associative" /* 0x0E */
-	};
-
-	if (code >= 0x01 && code <= 0x0E)
-		return type[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_cache_associativity_enum, code);
 }
 
 /*
@@ -2008,166 +2118,174 @@ static const char *dmi_port_type(u8 code)
  * 7.10 System Slots (Type 9)
  */
 
+/* 7.10.1 */
+static const char * const dmi_slot_type_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"ISA",
+	"MCA",
+	"EISA",
+	"PCI",
+	"PC Card (PCMCIA)",
+	"VLB",
+	"Proprietary",
+	"Processor Card",
+	"Proprietary Memory Card",
+	"I/O Riser Card",
+	"NuBus",
+	"PCI-66",
+	"AGP",
+	"AGP 2x",
+	"AGP 4x",
+	"PCI-X",
+	"AGP 8x",
+	"M.2 Socket 1-DP",
+	"M.2 Socket 1-SD",
+	"M.2 Socket 2",
+	"M.2 Socket 3",
+	"MXM Type I",
+	"MXM Type II",
+	"MXM Type III",
+	"MXM Type III-HE",
+	"MXM Type IV",
+	"MXM 3.0 Type A",
+	"MXM 3.0 Type B",
+	"PCI Express 2 SFF-8639 (U.2)",
+	"PCI Express 3 SFF-8639 (U.2)",
+	"PCI Express Mini 52-pin with bottom-side keep-outs",
+	"PCI Express Mini 52-pin without bottom-side keep-outs",
+	"PCI Express Mini 76-pin",
+	"PCI Express 4 SFF-8639 (U.2)",
+	"PCI Express 5 SFF-8639 (U.2)",
+	"OCP NIC 3.0 Small Form Factor (SFF)",
+	"OCP NIC 3.0 Large Form Factor (LFF)",
+	"OCP NIC Prior to 3.0" /* 0x28 */
+};
+static const char * const dmi_slot_type_0x30_names[] = {
+	"CXL FLexbus 1.0" /* 0x30 */
+};
+static const char * const dmi_slot_type_0xA0_names[] = {
+	"PC-98/C20", /* 0xA0 */
+	"PC-98/C24",
+	"PC-98/E",
+	"PC-98/Local Bus",
+	"PC-98/Card",
+	"PCI Express",
+	"PCI Express x1",
+	"PCI Express x2",
+	"PCI Express x4",
+	"PCI Express x8",
+	"PCI Express x16",
+	"PCI Express 2",
+	"PCI Express 2 x1",
+	"PCI Express 2 x2",
+	"PCI Express 2 x4",
+	"PCI Express 2 x8",
+	"PCI Express 2 x16",
+	"PCI Express 3",
+	"PCI Express 3 x1",
+	"PCI Express 3 x2",
+	"PCI Express 3 x4",
+	"PCI Express 3 x8",
+	"PCI Express 3 x16",
+	out_of_spec, /* 0xB7 */
+	"PCI Express 4",
+	"PCI Express 4 x1",
+	"PCI Express 4 x2",
+	"PCI Express 4 x4",
+	"PCI Express 4 x8",
+	"PCI Express 4 x16",
+	"PCI Express 5",
+	"PCI Express 5 x1",
+	"PCI Express 5 x2",
+	"PCI Express 5 x4",
+	"PCI Express 5 x8",
+	"PCI Express 5 x16",
+	"PCI Express 6+",
+	"EDSFF E1",
+	"EDSFF E3" /* 0xC6 */
+};
+/*
+ * Note to developers: when adding entries to these lists, check if
+ * function dmi_slot_id below needs updating too.
+ */
+
+static const struct dmi_enum dmi_slot_type_enum = {
+	0xFF, {
+		{ 0x01, ARRAY_SIZE(dmi_slot_type_names), dmi_slot_type_names },
+		{ 0x30, ARRAY_SIZE(dmi_slot_type_0x30_names), dmi_slot_type_0x30_names },
+		{ 0xA0, ARRAY_SIZE(dmi_slot_type_0xA0_names), dmi_slot_type_0xA0_names },
+	}
+};
+
 static const char *dmi_slot_type(u8 code)
 {
-	/* 7.10.1 */
-	static const char *type[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"ISA",
-		"MCA",
-		"EISA",
-		"PCI",
-		"PC Card (PCMCIA)",
-		"VLB",
-		"Proprietary",
-		"Processor Card",
-		"Proprietary Memory Card",
-		"I/O Riser Card",
-		"NuBus",
-		"PCI-66",
-		"AGP",
-		"AGP 2x",
-		"AGP 4x",
-		"PCI-X",
-		"AGP 8x",
-		"M.2 Socket 1-DP",
-		"M.2 Socket 1-SD",
-		"M.2 Socket 2",
-		"M.2 Socket 3",
-		"MXM Type I",
-		"MXM Type II",
-		"MXM Type III",
-		"MXM Type III-HE",
-		"MXM Type IV",
-		"MXM 3.0 Type A",
-		"MXM 3.0 Type B",
-		"PCI Express 2 SFF-8639 (U.2)",
-		"PCI Express 3 SFF-8639 (U.2)",
-		"PCI Express Mini 52-pin with bottom-side keep-outs",
-		"PCI Express Mini 52-pin without bottom-side keep-outs",
-		"PCI Express Mini 76-pin",
-		"PCI Express 4 SFF-8639 (U.2)",
-		"PCI Express 5 SFF-8639 (U.2)",
-		"OCP NIC 3.0 Small Form Factor (SFF)",
-		"OCP NIC 3.0 Large Form Factor (LFF)",
-		"OCP NIC Prior to 3.0" /* 0x28 */
-	};
-	static const char *type_0x30[] = {
-		"CXL FLexbus 1.0" /* 0x30 */
-	};
-	static const char *type_0xA0[] = {
-		"PC-98/C20", /* 0xA0 */
-		"PC-98/C24",
-		"PC-98/E",
-		"PC-98/Local Bus",
-		"PC-98/Card",
-		"PCI Express",
-		"PCI Express x1",
-		"PCI Express x2",
-		"PCI Express x4",
-		"PCI Express x8",
-		"PCI Express x16",
-		"PCI Express 2",
-		"PCI Express 2 x1",
-		"PCI Express 2 x2",
-		"PCI Express 2 x4",
-		"PCI Express 2 x8",
-		"PCI Express 2 x16",
-		"PCI Express 3",
-		"PCI Express 3 x1",
-		"PCI Express 3 x2",
-		"PCI Express 3 x4",
-		"PCI Express 3 x8",
-		"PCI Express 3 x16",
-		out_of_spec, /* 0xB7 */
-		"PCI Express 4",
-		"PCI Express 4 x1",
-		"PCI Express 4 x2",
-		"PCI Express 4 x4",
-		"PCI Express 4 x8",
-		"PCI Express 4 x16",
-		"PCI Express 5",
-		"PCI Express 5 x1",
-		"PCI Express 5 x2",
-		"PCI Express 5 x4",
-		"PCI Express 5 x8",
-		"PCI Express 5 x16",
-		"PCI Express 6+",
-		"EDSFF E1",
-		"EDSFF E3" /* 0xC6 */
-	};
-	/*
-	 * Note to developers: when adding entries to these lists, check if
-	 * function dmi_slot_id below needs updating too.
-	 */
-
-	if (code >= 0x01 && code <= 0x28)
-		return type[code - 0x01];
-	if (code == 0x30)
-		return type_0x30[code - 0x30];
-	if (code >= 0xA0 && code <= 0xC6)
-		return type_0xA0[code - 0xA0];
-	return out_of_spec;
-}
+	return dmi_enum_name(&dmi_slot_type_enum, code);
+}
+
+/* 7.10.2 */
+static const char * const dmi_slot_bus_width_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"8 bit",
+	"16 bit",
+	"32 bit",
+	"64 bit",
+	"128 bit",
+	"1x or x1",
+	"2x or x2",
+	"4x or x4",
+	"8x or x8",
+	"12x or x12",
+	"16x or x16",
+	"32x or x32" /* 0x0E */
+};
+
+static const struct dmi_enum dmi_slot_bus_width_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_slot_bus_width_names), dmi_slot_bus_width_names } }
+};
 
 static const char *dmi_slot_bus_width(u8 code)
 {
-	/* 7.10.2 */
-	static const char *width[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"8 bit",
-		"16 bit",
-		"32 bit",
-		"64 bit",
-		"128 bit",
-		"1x or x1",
-		"2x or x2",
-		"4x or x4",
-		"8x or x8",
-		"12x or x12",
-		"16x or x16",
-		"32x or x32" /* 0x0E */
-	};
-
-	if (code >= 0x01 && code <= 0x0E)
-		return width[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_slot_bus_width_enum, code);
 }
 
+/* 7.10.3 */
+static const char * const dmi_slot_current_usage_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"Available",
+	"In Use",
+	"Unavailable" /* 0x05 */
+};
+
+static const struct dmi_enum dmi_slot_current_usage_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_slot_current_usage_names), dmi_slot_current_usage_names } }
+};
+
 static const char *dmi_slot_current_usage(u8 code)
 {
-	/* 7.10.3 */
-	static const char *usage[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"Available",
-		"In Use",
-		"Unavailable" /* 0x05 */
-	};
-
-	if (code >= 0x01 && code <= 0x05)
-		return usage[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_slot_current_usage_enum, code);
 }
 
+/* 7.10.4 */
+static const char * const dmi_slot_length_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"Short",
+	"Long",
+	"2.5\" drive form factor",
+	"3.5\" drive form factor" /* 0x06 */
+};
+
+static const struct dmi_enum dmi_slot_length_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_slot_length_names), dmi_slot_length_names } }
+};
+
 static const char *dmi_slot_length(u8 code)
 {
-	/* 7.10.4 */
-	static const char *length[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"Short",
-		"Long",
-		"2.5\" drive form factor",
-		"3.5\" drive form factor" /* 0x06 */
-	};
-
-	if (code >= 0x01 && code <= 0x06)
-		return length[code - 0x01];
-	return out_of_spec;
-}
+	return dmi_enum_name(&dmi_slot_length_enum, code);
+}
 
 static void dmi_slot_id(u8 code1, u8 code2, u8 type)
 {
@@ -2234,7 +2352,7 @@ static void dmi_slot_id(u8 code1, u8 code2, u8 type)
 static void dmi_slot_characteristics(const char *attr, u8 code1, u8 code2)
 {
 	/* 7.10.6 */
-	static const char *characteristics1[] = {
+	static const char * const characteristics1[] = {
 		"5.0 V is provided", /* 1 */
 		"3.3 V is provided",
 		"Opening is shared",
@@ -2244,7 +2362,7 @@ static void dmi_slot_characteristics(const char *attr, u8 code1, u8 code2)
 		"Modem ring resume is supported" /* 7 */
 	};
 	/* 7.10.7 */
-	static const char *characteristics2[] = {
+	static const char * const characteristics2[] = {
 		"PME signal is supported", /* 0 */
 		"Hot-plug devices are supported",
 		"SMBus signal is supported",
@@ -2254,6 +2372,12 @@ static void dmi_slot_characteristics(const char *attr, u8 code1, u8 code2)
 		"Flexbus slot, CXL 2.0 capable",
 		"Flexbus slot, CXL 3.0 capable" /* 7 */
 	};
+	static const struct dmi_bitfield bits1 = {
+		1, ARRAY_SIZE(characteristics1), characteristics1
+	};
+	static const struct dmi_bitfield bits2 = {
+		0, ARRAY_SIZE(characteristics2), characteristics2
+	};
 
 	if (code1 & (1 << 0))
 		pr_attr(attr, "Unknown");
@@ -2261,15 +2385,9 @@ static void dmi_slot_characteristics(const char *attr, u8 code1, u8 code2)
 		pr_attr(attr, "None");
 	else
 	{
-		int i;
-
 		pr_list_start(attr, NULL);
-		for (i = 1; i <= 7; i++)
-			if (code1 & (1 << i))
-				pr_list_item("%s", characteristics1[i - 1]);
-		for (i = 0; i <= 7; i++)
-			if (code2 & (1 << i))
-				pr_list_item("%s", characteristics2[i]);
+		dmi_bitfield_list(&bits1, code1);
+		dmi_bitfield_list(&bits2, code2);
 		pr_list_end();
 	}
 }
@@ -2375,31 +2493,34 @@ static const char *dmi_slot_height(u8 code)
  * 7.11 On Board Devices Information (Type 10)
  */
 
+/* 7.11.1 and 7.42.2 */
+static const char * const dmi_on_board_devices_type_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"Video",
+	"SCSI Controller",
+	"Ethernet",
+	"Token Ring",
+	"Sound",
+	"PATA Controller",
+	"SATA Controller",
+	"SAS Controller",
+	"Wireless LAN",
+	"Bluetooth",
+	"WWAN",
+	"eMMC",
+	"NVMe Controller",
+	"UFS Controller" /* 0x10 */
+};
+
+/* The high bit is the device status */
+static const struct dmi_enum dmi_on_board_devices_type_enum = {
+	0x7F, { { 0x01, ARRAY_SIZE(dmi_on_board_devices_type_names), dmi_on_board_devices_type_names } }
+};
+
 static const char *dmi_on_board_devices_type(u8 code)
 {
-	/* 7.11.1 and 7.42.2 */
-	static const char *type[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"Video",
-		"SCSI Controller",
-		"Ethernet",
-		"Token Ring",
-		"Sound",
-		"PATA Controller",
-		"SATA Controller",
-		"SAS Controller",
-		"Wireless LAN",
-		"Bluetooth",
-		"WWAN",
-		"eMMC",
-		"NVMe Controller",
-		"UFS Controller" /* 0x10 */
-	};
-
-	if (code >= 0x01 && code <= 0x10)
-		return type[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_on_board_devices_type_enum, code);
 }
 
 static void dmi_on_board_devices(const struct dmi_header *h)
@@ -2569,7 +2690,7 @@ static const char *dmi_event_log_header_type(u8 code)
 	return out_of_spec;
 }
 
-static const char *dmi_event_log_descriptor_type(u8 code)
+const char *dmi_event_log_descriptor_type(u8 code)
 {
 	/* 7.16.6.1 */
 	static const char *type[] = {
@@ -2652,70 +2773,78 @@ static void dmi_event_log_descriptors(u8 count, u8 len, const u8 *p)
  * 7.17 Physical Memory Array (Type 16)
  */
 
+/* 7.17.1 */
+static const char * const dmi_memory_array_location_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"System Board Or Motherboard",
+	"ISA Add-on Card",
+	"EISA Add-on Card",
+	"PCI Add-on Card",
+	"MCA Add-on Card",
+	"PCMCIA Add-on Card",
+	"Proprietary Add-on Card",
+	"NuBus" /* 0x0A */
+};
+
+static const char * const dmi_memory_array_location_0xA0_names[] = {
+	"PC-98/C20 Add-on Card", /* 0xA0 */
+	"PC-98/C24 Add-on Card",
+	"PC-98/E Add-on Card",
+	"PC-98/Local Bus Add-on Card",
+	"CXL Add-on Card" /* 0xA4 */
+};
+
+static const struct dmi_enum dmi_memory_array_location_enum = {
+	0xFF, {
+		{ 0x01, ARRAY_SIZE(dmi_memory_array_location_names), dmi_memory_array_location_names },
+		{ 0xA0, ARRAY_SIZE(dmi_memory_array_location_0xA0_names), dmi_memory_array_location_0xA0_names },
+	}
+};
+
 static const char *dmi_memory_array_location(u8 code)
 {
-	/* 7.17.1 */
-	static const char *location[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"System Board Or Motherboard",
-		"ISA Add-on Card",
-		"EISA Add-on Card",
-		"PCI Add-on Card",
-		"MCA Add-on Card",
-		"PCMCIA Add-on Card",
-		"Proprietary Add-on Card",
-		"NuBus" /* 0x0A */
-	};
-	static const char *location_0xA0[] = {
-		"PC-98/C20 Add-on Card", /* 0xA0 */
-		"PC-98/C24 Add-on Card",
-		"PC-98/E Add-on Card",
-		"PC-98/Local Bus Add-on Card",
-		"CXL Add-on Card" /* 0xA4 */
-	};
-
-	if (code >= 0x01 && code <= 0x0A)
-		return location[code - 0x01];
-	if (code >= 0xA0 && code <= 0xA4)
-		return location_0xA0[code - 0xA0];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_memory_array_location_enum, code);
 }
 
+/* 7.17.2 */
+static const char * const dmi_memory_array_use_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"System Memory",
+	"Video Memory",
+	"Flash Memory",
+	"Non-volatile RAM",
+	"Cache Memory" /* 0x07 */
+};
+
+static const struct dmi_enum dmi_memory_array_use_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_memory_array_use_names), dmi_memory_array_use_names } }
+};
+
 static const char *dmi_memory_array_use(u8 code)
 {
-	/* 7.17.2 */
-	static const char *use[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"System Memory",
-		"Video Memory",
-		"Flash Memory",
-		"Non-volatile RAM",
-		"Cache Memory" /* 0x07 */
-	};
-
-	if (code >= 0x01 && code <= 0x07)
-		return use[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_memory_array_use_enum, code);
 }
 
+/* 7.17.3 */
+static const char * const dmi_memory_array_ec_type_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"None",
+	"Parity",
+	"Single-bit ECC",
+	"Multi-bit ECC",
+	"CRC" /* 0x07 */
+};
+
+static const struct dmi_enum dmi_memory_array_ec_type_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_memory_array_ec_type_names), dmi_memory_array_ec_type_names } }
+};
+
 static const char *dmi_memory_array_ec_type(u8 code)
 {
-	/* 7.17.3 */
-	static const char *type[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"None",
-		"Parity",
-		"Single-bit ECC",
-		"Multi-bit ECC",
-		"CRC" /* 0x07 */
-	};
-
-	if (code >= 0x01 && code <= 0x07)
-		return type[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_memory_array_ec_type_enum, code);
 }
 
 static void dmi_memory_array_error_handle(u16 code)
@@ -2783,31 +2912,33 @@ static void dmi_memory_voltage_value(const char *attr, u16 code)
 			(float)code / 1000);
 }
 
+/* 7.18.1 */
+static const char * const dmi_memory_device_form_factor_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"SIMM",
+	"SIP",
+	"Chip",
+	"DIP",
+	"ZIP",
+	"Proprietary Card",
+	"DIMM",
+	"TSOP",
+	"Row Of Chips",
+	"RIMM",
+	"SODIMM",
+	"SRIMM",
+	"FB-DIMM",
+	"Die" /* 0x10 */
+};
+
+static const struct dmi_enum dmi_memory_device_form_factor_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_memory_device_form_factor_names), dmi_memory_device_form_factor_names } }
+};
+
 static const char *dmi_memory_device_form_factor(u8 code)
 {
-	/* 7.18.1 */
-	static const char *form_factor[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"SIMM",
-		"SIP",
-		"Chip",
-		"DIP",
-		"ZIP",
-		"Proprietary Card",
-		"DIMM",
-		"TSOP",
-		"Row Of Chips",
-		"RIMM",
-		"SODIMM",
-		"SRIMM",
-		"FB-DIMM",
-		"Die" /* 0x10 */
-	};
-
-	if (code >= 0x01 && code <= 0x10)
-		return form_factor[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_memory_device_form_factor_enum, code);
 }
 
 static void dmi_memory_device_set(u8 code)
@@ -2820,57 +2951,59 @@ static void dmi_memory_device_set(u8 code)
 		pr_attr("Set", "%u", code);
 }
 
+/* 7.18.2 */
+static const char * const dmi_memory_device_type_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"DRAM",
+	"EDRAM",
+	"VRAM",
+	"SRAM",
+	"RAM",
+	"ROM",
+	"Flash",
+	"EEPROM",
+	"FEPROM",
+	"EPROM",
+	"CDRAM",
+	"3DRAM",
+	"SDRAM",
+	"SGRAM",
+	"RDRAM",
+	"DDR",
+	"DDR2",
+	"DDR2 FB-DIMM",
+	"Reserved",
+	"Reserved",
+	"Reserved",
+	"DDR3",
+	"FBD2",
+	"DDR4",
+	"LPDDR",
+	"LPDDR2",
+	"LPDDR3",
+	"LPDDR4",
+	"Logical non-volatile device",
+	"HBM",
+	"HBM2",
+	"DDR5",
+	"LPDDR5",
+	"HBM3" /* 0x24 */
+};
+
+static const struct dmi_enum dmi_memory_device_type_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_memory_device_type_names), dmi_memory_device_type_names } }
+};
+
 static const char *dmi_memory_device_type(u8 code)
 {
-	/* 7.18.2 */
-	static const char *type[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"DRAM",
-		"EDRAM",
-		"VRAM",
-		"SRAM",
-		"RAM",
-		"ROM",
-		"Flash",
-		"EEPROM",
-		"FEPROM",
-		"EPROM",
-		"CDRAM",
-		"3DRAM",
-		"SDRAM",
-		"SGRAM",
-		"RDRAM",
-		"DDR",
-		"DDR2",
-		"DDR2 FB-DIMM",
-		"Reserved",
-		"Reserved",
-		"Reserved",
-		"DDR3",
-		"FBD2",
-		"DDR4",
-		"LPDDR",
-		"LPDDR2",
-		"LPDDR3",
-		"LPDDR4",
-		"Logical non-volatile device",
-		"HBM",
-		"HBM2",
-		"DDR5",
-		"LPDDR5",
-		"HBM3" /* 0x24 */
-	};
-
-	if (code >= 0x01 && code <= 0x24)
-		return type[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_memory_device_type_enum, code);
 }
 
 static void dmi_memory_device_type_detail(u16 code)
 {
 	/* 7.18.3 */
-	static const char *detail[] = {
+	static const char * const detail[] = {
 		"Other", /* 1 */
 		"Unknown",
 		"Fast-paged",
@@ -2887,20 +3020,17 @@ static void dmi_memory_device_type_detail(u16 code)
 		"Unbuffered (Unregistered)",
 		"LRDIMM"  /* 15 */
 	};
+	static const struct dmi_bitfield bits = {
+		1, ARRAY_SIZE(detail), detail
+	};
 	char list[172];		/* Update length if you touch the array above */
 
 	if ((code & 0xFFFE) == 0)
 		pr_attr("Type Detail", "None");
 	else
 	{
-		int i, off = 0;
-
-		list[0] = '\0';
-		for (i = 1; i <= 15; i++)
-			if (code & (1 << i))
-				off += sprintf(list + off, off ? " %s" : "%s",
-					       detail[i - 1]);
-		pr_attr("Type Detail", list);
+		dmi_bitfield_join(&bits, code, list, sizeof(list));
+		pr_attr("Type Detail", "%s", list);
 	}
 }
 
@@ -2950,19 +3080,16 @@ static void dmi_memory_operating_mode_capability(u16 code)
 		"Byte-accessible persistent memory",
 		"Block-accessible persistent memory" /* 5 */
 	};
+	static const struct dmi_bitfield bits = {
+		1, ARRAY_SIZE(mode), mode
+	};
 	char list[99];		/* Update length if you touch the array above */
 
 	if ((code & 0xFFFE) == 0)
 		pr_attr("Memory Operating Mode Capability", "None");
 	else {
-		int i, off = 0;
-
-		list[0] = '\0';
-		for (i = 1; i <= 5; i++)
-			if (code & (1 << i))
-				off += sprintf(list + off, off ? " %s" : "%s",
-					       mode[i - 1]);
-		pr_attr("Memory Operating Mode Capability", list);
+		dmi_bitfield_join(&bits, code, list, sizeof(list));
+		pr_attr("Memory Operating Mode Capability", "%s", list);
 	}
 }
 
@@ -3045,60 +3172,66 @@ static void dmi_memory_revision(const char *attr_type, u16 code, u8 mem_type)
  * 7.19 32-bit Memory Error Information (Type 18)
  */
 
+/* 7.19.1 */
+static const char * const dmi_memory_error_type_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"OK",
+	"Bad Read",
+	"Parity Error",
+	"Single-bit Error",
+	"Double-bit Error",
+	"Multi-bit Error",
+	"Nibble Error",
+	"Checksum Error",
+	"CRC Error",
+	"Corrected Single-bit Error",
+	"Corrected Error",
+	"Uncorrectable Error" /* 0x0E */
+};
+
+static const struct dmi_enum dmi_memory_error_type_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_memory_error_type_names), dmi_memory_error_type_names } }
+};
+
 static const char *dmi_memory_error_type(u8 code)
 {
-	/* 7.19.1 */
-	static const char *type[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"OK",
-		"Bad Read",
-		"Parity Error",
-		"Single-bit Error",
-		"Double-bit Error",
-		"Multi-bit Error",
-		"Nibble Error",
-		"Checksum Error",
-		"CRC Error",
-		"Corrected Single-bit Error",
-		"Corrected Error",
-		"Uncorrectable Error" /* 0x0E */
-	};
-
-	if (code >= 0x01 && code <= 0x0E)
-		return type[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_memory_error_type_enum, code);
 }
 
+/* 7.19.2 */
+static const char * const dmi_memory_error_granularity_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"Device Level",
+	"Memory Partition Level" /* 0x04 */
+};
+
+static const struct dmi_enum dmi_memory_error_granularity_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_memory_error_granularity_names), dmi_memory_error_granularity_names } }
+};
+
 static const char *dmi_memory_error_granularity(u8 code)
 {
-	/* 7.19.2 */
-	static const char *granularity[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"Device Level",
-		"Memory Partition Level" /* 0x04 */
-	};
-
-	if (code >= 0x01 && code <= 0x04)
-		return granularity[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_memory_error_granularity_enum, code);
 }
 
+/* 7.19.3 */
+static const char * const dmi_memory_error_operation_names[] = {
+	"Other", /* 0x01 */
+	"Unknown",
+	"Read",
+	"Write",
+	"Partial Write" /* 0x05 */
+};
+
+static const struct dmi_enum dmi_memory_error_operation_enum = {
+	0xFF, { { 0x01, ARRAY_SIZE(dmi_memory_error_operation_names), dmi_memory_error_operation_names } }
+};
+
 static const char *dmi_memory_error_operation(u8 code)
 {
-	/* 7.19.3 */
-	static const char *operation[] = {
-		"Other", /* 0x01 */
-		"Unknown",
-		"Read",
-		"Write",
-		"Partial Write" /* 0x05 */
-	};
-
-	if (code >= 0x01 && code <= 0x05)
-		return operation[code - 0x01];
-	return out_of_spec;
+	return dmi_enum_name(&dmi_memory_error_operation_enum, code);
 }
 
 static void dmi_memory_error_syndrome(u32 code)
@@ -3677,7 +3810,7 @@ static void dmi_memory_channel_devices(u8 count, const u8 *p)
  * 7.39 IPMI Device Information (Type 38)
  */
 
-static const char *dmi_ipmi_interface_type(u8 code)
+const char *dmi_ipmi_interface_type(u8 code)
 {
 	/* 7.39.1 and IPMI 2.0, appendix C1, table C1-2 */
 	static const char *type[] = {
@@ -3693,23 +3826,38 @@ static const char *dmi_ipmi_interface_type(u8 code)
 	return out_of_spec;
 }
 
-static void dmi_ipmi_base_address(u8 type, const u8 *p, u8 lsb)
+/*
+ * Base address and address space of the interface, as displayed when
+ * decoding. The address is an SMBus slave address for SSIF.
+ */
+const char *dmi_ipmi_base_address_value(u8 type, const u8 *p, u8 lsb,
+					char *buf, size_t size)
 {
 	if (type == 0x04) /* SSIF */
 	{
-		pr_attr("Base Address", "0x%02X (SMBus)", (*p) >> 1);
+		snprintf(buf, size, "0x%02X", (*p) >> 1);
+		return "SMBus";
 	}
 	else
 	{
 		u64 address = QWORD(p);
-		pr_attr("Base Address", "0x%08X%08X (%s)",
-			address.h, (address.l & ~1) | lsb,
-			address.l & 1 ? "I/O" : "Memory-mapped");
+		snprintf(buf, size, "0x%08X%08X",
+			 address.h, (address.l & ~1) | lsb);
+		return address.l & 1 ? "I/O" : "Memory-mapped";
 	}
 }
 
+static void dmi_ipmi_base_address(u8 type, const u8 *p, u8 lsb)
+{
+	const char *space;
+	char buf[20];
+
+	space = dmi_ipmi_base_address_value(type, p, lsb, buf, sizeof(buf));
+	pr_attr("Base Address", "%s (%s)", buf, space);
+}
+
 /* code is assumed to be a 2-bit value */
-static const char *dmi_ipmi_register_spacing(u8 code)
+const char *dmi_ipmi_register_spacing(u8 code)
 {
 	/* IPMI 2.0, appendix C1, table C1-1 */
 	static const char *spacing[] = {
@@ -3889,7 +4037,7 @@ static const char *dmi_protocol_record_type(u8 type)
 /*
  * DSP0270: 8.4.2: Protocol IP Assignment types
  */
-static const char *dmi_protocol_assignment_type(u8 type)
+const char *dmi_protocol_assignment_type(u8 type)
 {
 	const char *assignment[] = {
 		"Unknown",		/* 0x0 */
@@ -3907,7 +4055,7 @@ static const char *dmi_protocol_assignment_type(u8 type)
 /*
  * DSP0270: 8.4.3: Protocol IP Address type
  */
-static const char *dmi_address_type(u8 type)
+const char *dmi_address_type(u8 type)
 {
 	const char *addressformat[] = {
 		"Unknown",	/* 0x0 */
@@ -3923,7 +4071,7 @@ static const char *dmi_address_type(u8 type)
 /*
  *  DSP0270: 8.4.3 Protocol Address decode
  */
-static const char *dmi_address_decode(u8 *data, char *storage, u8 addrtype)
+const char *dmi_address_decode(const u8 *data, char *storage, u8 addrtype)
 {
 	if (addrtype == 0x1) /* IPv4 */
 		return inet_ntop(AF_INET, data, storage, 64);
@@ -4073,7 +4221,7 @@ static void dmi_parse_protocol_record(u8 *rec)
 /*
  * DSP0270: 8.3: Device type ennumeration
  */
-static const char *dmi_parse_device_type(u8 type)
+const char *dmi_parse_device_type(u8 type)
 {
 	const char *devname[] = {
 		"USB",		/* 0x2 */
@@ -4094,21 +4242,18 @@ static const char *dmi_parse_device_type(u8 type)
  */
 static void dmi_device_characteristics(u16 code)
 {
-	const char *characteristics[] = {
+	static const char * const characteristics[] = {
 		"Credential bootstrapping via IPMI is supported", /* 0 */
 		/* Reserved */
 	};
+	static const struct dmi_bitfield bits = {
+		0, ARRAY_SIZE(characteristics), characteristics
+	};
 
 	if ((code & 0x1) == 0)
 		pr_list_item("None");
 	else
-	{
-		int i;
-
-		for (i = 0; i < 1; i++)
-			if (code & (1 << i))
-				pr_list_item("%s", characteristics[i]);
-	}
+		dmi_bitfield_list(&bits, code);
 }
 
 static void dmi_parse_controller_structure(const struct dmi_header *h)
@@ -4362,13 +4507,15 @@ static void dmi_tpm_vendor_id(const u8 *p)
 static void dmi_tpm_characteristics(u64 code)
 {
 	/* 7.1.1 */
-	static const char *characteristics[] = {
+	static const char * const characteristics[] = {
 		"TPM Device characteristics not supported", /* 2 */
 		"Family configurable via firmware update",
 		"Family configurable via platform software support",
 		"Family configurable via OEM proprietary mechanism" /* 5 */
 	};
-	int i;
+	static const struct dmi_bitfield bits = {
+		2, ARRAY_SIZE(characteristics), characteristics
+	};
 
 	/*
 	 * This isn't very clear what this bit is supposed to mean
@@ -4379,9 +4526,7 @@ static void dmi_tpm_characteristics(u64 code)
 		return;
 	}
 
-	for (i = 3; i <= 5; i++)
-		if (code.l & (1 << i))
-			pr_list_item("%s", characteristics[i - 2]);
+	dmi_bitfield_list(&bits, code.l);
 }
 
 /*
@@ -5539,154 +5684,344 @@ static void dmi_decode(const struct dmi_header *h, u16 ver)
 	pr_sep();
 }
 
-static void to_dmi_header(struct dmi_header *h, u8 *data)
+/*
+ * Field descriptors
+ *
+ * The most commonly requested fields are described in a table, so that
+ * they can be looked up by name and extracted individually, without
+ * decoding the whole structure. Values are formatted exactly as in the
+ * full decoding output, by reusing the same helper functions.
+ */
+
+static void dmi_field_revision(const struct dmi_field *f,
+			       const struct dmi_header *h, u16 ver)
 {
-	h->type = data[0];
-	h->length = data[1];
-	h->handle = WORD(data + 2);
-	h->data = data;
+	const u8 *p = h->data + f->offset;
+
+	(void) ver;
+	if (p[0] != 0xFF && p[1] != 0xFF)
+		pr_attr(f->name, "%u.%u", p[0], p[1]);
 }
 
-static void dmi_table_string(const struct dmi_header *h, const u8 *data, u16 ver)
+static void dmi_field_uuid(const struct dmi_field *f,
+			   const struct dmi_header *h, u16 ver)
 {
-	int key;
-	u8 offset = opt.string->offset;
+	dmi_system_uuid(pr_attr, f->name, h->data + f->offset, ver);
+}
 
-	if (opt.string->type == 11) /* OEM strings */
-	{
-		if (h->length < 5 || offset > data[4])
-		{
-			fprintf(stderr, "No OEM string number %u\n", offset);
-			return;
-		}
+static void dmi_field_processor_family(const struct dmi_field *f,
+				       const struct dmi_header *h, u16 ver)
+{
+	pr_attr(f->name, "%s", dmi_processor_family(h, ver));
+}
 
-		if (offset)
-			printf("%s\n", dmi_string(h, offset));
-		else
-			printf("%u\n", data[4]);	/* count */
-		return;
-	}
+static void dmi_field_processor_frequency(const struct dmi_field *f,
+					  const struct dmi_header *h, u16 ver)
+{
+	(void) ver;
+	dmi_processor_frequency(f->name, h->data + f->offset);
+}
+
+/* Core and thread counts may be extended to 16-bit values */
+unsigned int dmi_processor_count(const struct dmi_header *h, u8 offset)
+{
+	const u8 *data = h->data;
+	u8 ext = 0x2A + 2 * (offset - 0x23);
 
-	if (offset >= h->length)
+	if (h->length <= offset)
+		return 0;
+	return h->length >= ext + 2 && data[offset] == 0xFF ?
+		WORD(data + ext) : data[offset];
+}
+
+static void dmi_field_processor_count(const struct dmi_field *f,
+				      const struct dmi_header *h, u16 ver)
+{
+	(void) ver;
+	if (h->data[f->offset] == 0)
 		return;
+	pr_attr(f->name, "%u", dmi_processor_count(h, f->offset));
+}
 
-	key = (opt.string->type << 8) | offset;
-	switch (key)
-	{
-		case 0x015: /* -s bios-revision */
-			if (data[offset - 1] != 0xFF && data[offset] != 0xFF)
-				printf("%u.%u\n", data[offset - 1], data[offset]);
-			break;
-		case 0x017: /* -s firmware-revision */
-			if (data[offset - 1] != 0xFF && data[offset] != 0xFF)
-				printf("%u.%u\n", data[offset - 1], data[offset]);
-			break;
-		case 0x108:
-			dmi_system_uuid(NULL, NULL, data + offset, ver);
-			break;
-		case 0x305:
-			printf("%s\n", dmi_chassis_type(data[offset]));
-			break;
-		case 0x406:
-			printf("%s\n", dmi_processor_family(h, ver));
-			break;
-		case 0x416:
-			dmi_processor_frequency(NULL, data + offset);
-			break;
-		default:
-			printf("%s\n", dmi_string(h, data[offset]));
-	}
+static void dmi_field_memory_device_width(const struct dmi_field *f,
+					  const struct dmi_header *h, u16 ver)
+{
+	(void) ver;
+	dmi_memory_device_width(f->name, WORD(h->data + f->offset));
 }
 
-static int dmi_table_dump(const u8 *ep, u32 ep_len, const u8 *table,
-			  u32 table_len)
+/* Size of a memory device in kB, 0 if not installed or unknown */
+unsigned long long dmi_memory_device_size_kb(const struct dmi_header *h)
 {
-	int fd;
-	FILE *f;
+	const u8 *data = h->data;
+	u16 code;
 
-	fd = open(opt.dumpfile, O_WRONLY|O_CREAT|O_EXCL, 0666);
-	if (fd == -1)
-	{
-		fprintf(stderr, "%s: ", opt.dumpfile);
-		perror("open");
-		return -1;
-	}
+	if (h->length < 0x0E)
+		return 0;
+	code = WORD(data + 0x0C);
+	if (code == 0 || code == 0xFFFF)
+		return 0;
+	if (code == 0x7FFF && h->length >= 0x20)
+		return (unsigned long long)(DWORD(data + 0x1C) & 0x7FFFFFFFUL) << 10;
+	if (code & 0x8000)
+		return code & 0x7FFF;
+	return (unsigned long long)code << 10;
+}
 
-	f = fdopen(fd, "wb");
-	if (!f)
-	{
-		fprintf(stderr, "%s: ", opt.dumpfile);
-		perror("fdopen");
-		return -1;
-	}
+static void dmi_field_memory_device_size(const struct dmi_field *f,
+					 const struct dmi_header *h, u16 ver)
+{
+	const u8 *data = h->data;
 
-	if (!(opt.flags & FLAG_QUIET))
-		pr_comment("Writing %d bytes to %s.", ep_len, opt.dumpfile);
-	if (fwrite(ep, ep_len, 1, f) != 1)
-	{
-		fprintf(stderr, "%s: ", opt.dumpfile);
-		perror("fwrite");
-		goto err_close;
-	}
+	(void) f;
+	(void) ver;
+	if (h->length >= 0x20 && WORD(data + 0x0C) == 0x7FFF)
+		dmi_memory_device_extended_size(DWORD(data + 0x1C));
+	else
+		dmi_memory_device_size(WORD(data + 0x0C));
+}
 
-	if (fseek(f, 32, SEEK_SET) != 0)
-	{
-		fprintf(stderr, "%s: ", opt.dumpfile);
-		perror("fseek");
-		goto err_close;
-	}
+/* The extended speed fields are at 0x54 and 0x58 */
+static void dmi_field_memory_device_speed(const struct dmi_field *f,
+					  const struct dmi_header *h, u16 ver)
+{
+	const u8 *data = h->data;
+	u8 ext = f->offset == 0x15 ? 0x54 : 0x58;
 
-	if (!(opt.flags & FLAG_QUIET))
-		pr_comment("Writing %d bytes to %s.", table_len, opt.dumpfile);
-	if (fwrite(table, table_len, 1, f) != 1)
-	{
-		fprintf(stderr, "%s: ", opt.dumpfile);
-		perror("fwrite");
-		goto err_close;
-	}
+	(void) ver;
+	dmi_memory_device_speed(f->name, WORD(data + f->offset),
+				h->length >= 0x5C ? DWORD(data + ext) : 0);
+}
 
-	if (fclose(f))
+static void dmi_field_memory_device_rank(const struct dmi_field *f,
+					 const struct dmi_header *h, u16 ver)
+{
+	u8 rank = h->data[f->offset] & 0x0F;
+
+	(void) ver;
+	if (rank == 0)
+		pr_attr(f->name, "Unknown");
+	else
+		pr_attr(f->name, "%u", rank);
+}
+
+#define FIELD_STR(t, off, name) \
+	{ t, off, 1, off + 1, FIELD_STRING, name, NULL, NULL }
+#define FIELD_ENUM(t, off, name, e) \
+	{ t, off, 1, off + 1, FIELD_ENUM, name, e, NULL }
+#define FIELD_NUM(t, off, w, name) \
+	{ t, off, w, off + w, FIELD_NUMBER, name, NULL, NULL }
+#define FIELD_FN(t, off, w, name, fn) \
+	{ t, off, w, off + w, FIELD_CUSTOM, name, NULL, fn }
+
+/* Sorted by type, then by offset */
+const struct dmi_field dmi_fields[] = {
+	FIELD_STR(0, 0x04, "Vendor"),
+	FIELD_STR(0, 0x05, "Version"),
+	FIELD_STR(0, 0x08, "Release Date"),
+	FIELD_FN(0, 0x14, 2, "BIOS Revision", dmi_field_revision),
+	FIELD_FN(0, 0x16, 2, "Firmware Revision", dmi_field_revision),
+
+	FIELD_STR(1, 0x04, "Manufacturer"),
+	FIELD_STR(1, 0x05, "Product Name"),
+	FIELD_STR(1, 0x06, "Version"),
+	FIELD_STR(1, 0x07, "Serial Number"),
+	FIELD_FN(1, 0x08, 16, "UUID", dmi_field_uuid),
+	FIELD_ENUM(1, 0x18, "Wake-up Type", &dmi_system_wake_up_type_enum),
+	FIELD_STR(1, 0x19, "SKU Number"),
+	FIELD_STR(1, 0x1A, "Family"),
+
+	FIELD_STR(2, 0x04, "Manufacturer"),
+	FIELD_STR(2, 0x05, "Product Name"),
+	FIELD_STR(2, 0x06, "Version"),
+	FIELD_STR(2, 0x07, "Serial Number"),
+	FIELD_STR(2, 0x08, "Asset Tag"),
+	FIELD_STR(2, 0x0A, "Location In Chassis"),
+	FIELD_ENUM(2, 0x0D, "Type", &dmi_base_board_type_enum),
+
+	FIELD_STR(3, 0x04, "Manufacturer"),
+	FIELD_ENUM(3, 0x05, "Type", &dmi_chassis_type_enum),
+	FIELD_STR(3, 0x06, "Version"),
+	FIELD_STR(3, 0x07, "Serial Number"),
+	FIELD_STR(3, 0x08, "Asset Tag"),
+	FIELD_ENUM(3, 0x09, "Boot-up State", &dmi_chassis_state_enum),
+	FIELD_ENUM(3, 0x0A, "Power Supply State", &dmi_chassis_state_enum),
+	FIELD_ENUM(3, 0x0B, "Thermal State", &dmi_chassis_state_enum),
+	FIELD_ENUM(3, 0x0C, "Security Status", &dmi_chassis_security_status_enum),
+
+	FIELD_STR(4, 0x04, "Socket Designation"),
+	FIELD_ENUM(4, 0x05, "Type", &dmi_processor_type_enum),
+	FIELD_FN(4, 0x06, 1, "Family", dmi_field_processor_family),
+	FIELD_STR(4, 0x07, "Manufacturer"),
+	FIELD_STR(4, 0x10, "Version"),
+	FIELD_FN(4, 0x12, 2, "External Clock", dmi_field_processor_frequency),
+	FIELD_FN(4, 0x14, 2, "Max Speed", dmi_field_processor_frequency),
+	FIELD_FN(4, 0x16, 2, "Current Speed", dmi_field_processor_frequency),
+	FIELD_ENUM(4, 0x19, "Upgrade", &dmi_processor_upgrade_enum),
+	FIELD_STR(4, 0x20, "Serial Number"),
+	FIELD_STR(4, 0x21, "Asset Tag"),
+	FIELD_STR(4, 0x22, "Part Number"),
+	FIELD_FN(4, 0x23, 1, "Core Count", dmi_field_processor_count),
+	FIELD_FN(4, 0x24, 1, "Core Enabled", dmi_field_processor_count),
+	FIELD_FN(4, 0x25, 1, "Thread Count", dmi_field_processor_count),
+
+	FIELD_STR(7, 0x04, "Socket Designation"),
+	FIELD_ENUM(7, 0x10, "Error Correction Type", &dmi_cache_ec_type_enum),
+	FIELD_ENUM(7, 0x11, "System Type", &dmi_cache_type_enum),
+	FIELD_ENUM(7, 0x12, "Associativity", &dmi_cache_associativity_enum),
+
+	FIELD_STR(9, 0x04, "Designation"),
+	FIELD_ENUM(9, 0x05, "Type", &dmi_slot_type_enum),
+	FIELD_ENUM(9, 0x06, "Data Bus Width", &dmi_slot_bus_width_enum),
+	FIELD_ENUM(9, 0x07, "Current Usage", &dmi_slot_current_usage_enum),
+	FIELD_ENUM(9, 0x08, "Length", &dmi_slot_length_enum),
+
+	FIELD_ENUM(16, 0x04, "Location", &dmi_memory_array_location_enum),
+	FIELD_ENUM(16, 0x05, "Use", &dmi_memory_array_use_enum),
+	FIELD_ENUM(16, 0x06, "Error Correction Type", &dmi_memory_array_ec_type_enum),
+	FIELD_NUM(16, 0x0D, 2, "Number Of Devices"),
+
+	FIELD_FN(17, 0x08, 2, "Total Width", dmi_field_memory_device_width),
+	FIELD_FN(17, 0x0A, 2, "Data Width", dmi_field_memory_device_width),
+	FIELD_FN(17, 0x0C, 2, "Size", dmi_field_memory_device_size),
+	FIELD_ENUM(17, 0x0E, "Form Factor", &dmi_memory_device_form_factor_enum),
+	FIELD_STR(17, 0x10, "Locator"),
+	FIELD_STR(17, 0x11, "Bank Locator"),
+	FIELD_ENUM(17, 0x12, "Type", &dmi_memory_device_type_enum),
+	FIELD_FN(17, 0x15, 2, "Speed", dmi_field_memory_device_speed),
+	FIELD_STR(17, 0x17, "Manufacturer"),
+	FIELD_STR(17, 0x18, "Serial Number"),
+	FIELD_STR(17, 0x19, "Asset Tag"),
+	FIELD_STR(17, 0x1A, "Part Number"),
+	FIELD_FN(17, 0x1B, 1, "Rank", dmi_field_memory_device_rank),
+	FIELD_FN(17, 0x20, 2, "Configured Memory Speed", dmi_field_memory_device_speed),
+
+	FIELD_ENUM(18, 0x04, "Type", &dmi_memory_error_type_enum),
+	FIELD_ENUM(18, 0x05, "Granularity", &dmi_memory_error_granularity_enum),
+	FIELD_ENUM(18, 0x06, "Operation", &dmi_memory_error_operation_enum),
+
+	FIELD_ENUM(33, 0x04, "Type", &dmi_memory_error_type_enum),
+	FIELD_ENUM(33, 0x05, "Granularity", &dmi_memory_error_granularity_enum),
+	FIELD_ENUM(33, 0x06, "Operation", &dmi_memory_error_operation_enum),
+
+	FIELD_STR(41, 0x04, "Reference Designation"),
+	FIELD_ENUM(41, 0x05, "Type", &dmi_on_board_devices_type_enum),
+};
+
+const unsigned int dmi_field_count = ARRAY_SIZE(dmi_fields);
+
+const struct dmi_field *dmi_field_find(u8 type, const char *name)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(dmi_fields); i++)
+		if (dmi_fields[i].type == type
+		 && !strcasecmp(dmi_fields[i].name, name))
+			return &dmi_fields[i];
+
+	return NULL;
+}
+
+/* Returns the field which covers the given offset */
+const struct dmi_field *dmi_field_at(u8 type, u8 offset)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(dmi_fields); i++)
+		if (dmi_fields[i].type == type
+		 && offset >= dmi_fields[i].offset
+		 && offset < dmi_fields[i].offset + dmi_fields[i].width)
+			return &dmi_fields[i];
+
+	return NULL;
+}
+
+/*
+ * Returns the value of field f in structure h, or NULL if the structure
+ * doesn't have it. The returned value is either a pointer to buf, or a
+ * pointer to a constant or table string.
+ */
+const char *dmi_field_value(const struct dmi_field *f,
+			    const struct dmi_header *h, u16 ver,
+			    char *buf, size_t size)
+{
+	const u8 *p = h->data + f->offset;
+
+	if (h->type != f->type || h->length < f->length)
+		return NULL;
+
+	switch (f->format)
 	{
-		fprintf(stderr, "%s: ", opt.dumpfile);
-		perror("fclose");
-		return -1;
+		case FIELD_STRING:
+			return dmi_string(h, *p);
+		case FIELD_ENUM:
+			return dmi_enum_name(f->values, *p);
+		case FIELD_NUMBER:
+			snprintf(buf, size, "%u", f->width == 1 ? *p :
+				 f->width == 2 ? WORD(p) : DWORD(p));
+			return buf;
+		case FIELD_CUSTOM:
+			pr_capture_start(buf, size);
+			f->decode(f, h, ver);
+			if (!pr_capture_end())
+				return NULL;
+			return buf;
 	}
 
-	return 0;
+	return NULL;
+}
 
-err_close:
-	fclose(f);
-	return -1;
+static void to_dmi_header(struct dmi_header *h, u8 *data)
+{
+	h->type = data[0];
+	h->length = data[1];
+	h->handle = WORD(data + 2);
+	h->data = data;
 }
 
-static void dmi_table_decode(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
+/*
+ * Structure index
+ */
+
+static int dmi_index_cmp_handle(const void *a, const void *b)
 {
-	u8 *data;
-	int i = 0;
+	const struct dmi_index_entry *ea = *(const struct dmi_index_entry * const *)a;
+	const struct dmi_index_entry *eb = *(const struct dmi_index_entry * const *)b;
 
-	/* First pass: Save specific values needed to decode OEM types */
-	data = buf;
-	while ((i < num || !num)
+	if (ea->h.handle != eb->h.handle)
+		return ea->h.handle < eb->h.handle ? -1 : 1;
+	/* Keep duplicate handles in table order */
+	return ea < eb ? -1 : ea > eb;
+}
+
+/*
+ * Record the location of every structure of a table, so that they can be
+ * accessed in any order. Stops at the first broken or truncated structure,
+ * like dmi_table_decode() does. Returns -1 on allocation failure.
+ */
+int dmi_index_build(struct dmi_index *idx, u8 *buf, u32 len, u16 num,
+		    int stop_at_eot)
+{
+	unsigned int max = 64, i;
+	u8 *data = buf;
+
+	idx->count = 0;
+	idx->by_handle = NULL;
+	idx->entry = malloc(max * sizeof(*idx->entry));
+	if (idx->entry == NULL)
+		goto err;
+
+	while ((idx->count < num || !num)
 	    && data + 4 <= buf + len) /* 4 is the length of an SMBIOS structure header */
 	{
+		struct dmi_index_entry *e;
 		u8 *next;
-		struct dmi_header h;
 
-		to_dmi_header(&h, data);
-
-		/*
-		 * If a short entry is found (less than 4 bytes), not only it
-		 * is invalid, but we cannot reliably locate the next entry.
-		 * Also stop at end-of-table marker if so instructed.
-		 */
-		if (h.length < 4 ||
-		    (h.type == 127 &&
-		     (opt.flags & (FLAG_QUIET | FLAG_STOP_AT_EOT))))
-			break;
-		i++;
+		if (data[1] < 4)
+			break;
 
 		/* Look for the next handle */
-		next = data + h.length;
+		next = data + data[1];
 		while ((unsigned long)(next - buf + 1) < len
 		    && (next[0] != 0 || next[1] != 0))
 			next++;
@@ -5696,32 +6031,287 @@ static void dmi_table_decode(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
 		if ((unsigned long)(next - buf) > len)
 			break;
 
-		/* Assign vendor for vendor-specific decodes later */
-		if (h.type == 1 && h.length >= 6)
-			dmi_set_vendor(_dmi_string(&h, data[0x04], 0),
-				       _dmi_string(&h, data[0x05], 0));
+		if (idx->count == max)
+		{
+			struct dmi_index_entry *p;
 
-		/* Remember CPUID type for HPE type 199 */
-		if (h.type == 4 && h.length >= 0x1A && cpuid_type == cpuid_none)
-			cpuid_type = dmi_get_cpuid_type(&h);
+			max *= 2;
+			p = realloc(idx->entry, max * sizeof(*idx->entry));
+			if (p == NULL)
+				goto err;
+			idx->entry = p;
+		}
+
+		e = &idx->entry[idx->count++];
+		to_dmi_header(&e->h, data);
+		e->size = next - data;
+
+		if (e->h.type == 127 && stop_at_eot)
+			break;
 		data = next;
 	}
 
-	/* Second pass: Actually decode the data */
-	i = 0;
-	data = buf;
+	idx->by_handle = malloc((idx->count ? idx->count : 1)
+				* sizeof(*idx->by_handle));
+	if (idx->by_handle == NULL)
+		goto err;
+	for (i = 0; i < idx->count; i++)
+		idx->by_handle[i] = &idx->entry[i];
+	qsort(idx->by_handle, idx->count, sizeof(*idx->by_handle),
+	      dmi_index_cmp_handle);
+
+	return 0;
+
+err:
+	perror("malloc");
+	dmi_index_free(idx);
+	return -1;
+}
+
+void dmi_index_free(struct dmi_index *idx)
+{
+	free(idx->entry);
+	free(idx->by_handle);
+	idx->entry = NULL;
+	idx->by_handle = NULL;
+	idx->count = 0;
+}
+
+/* Returns the first structure with the given handle, or NULL */
+const struct dmi_index_entry *dmi_index_find(const struct dmi_index *idx,
+					     u16 handle)
+{
+	unsigned int low = 0, high = idx->count;
+
+	while (low < high)
+	{
+		unsigned int mid = (low + high) / 2;
+
+		if (idx->by_handle[mid]->h.handle < handle)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (low < idx->count && idx->by_handle[low]->h.handle == handle)
+		return idx->by_handle[low];
+	return NULL;
+}
+
+/*
+ * Values of --string and --field are displayed one per line, or as the
+ * elements of a JSON array
+ */
+static unsigned int dmi_value_count;
+
+static void dmi_table_value(const char *value)
+{
+	if (opt.flags & FLAG_JSON)
+	{
+		printf("%s\n  ", dmi_value_count++ ? "," : "");
+		pr_json_string(value);
+	}
+	else
+		printf("%s\n", value);
+}
+
+static void dmi_table_string(const struct dmi_header *h, const u8 *data, u16 ver)
+{
+	const struct dmi_field *f;
+	const char *value;
+	char buf[80];
+	u8 offset = opt.string->offset;
+
+	if (opt.string->type == 11) /* OEM strings */
+	{
+		if (h->length < 5 || offset > data[4])
+		{
+			fprintf(stderr, "No OEM string number %u\n", offset);
+			return;
+		}
+
+		if (offset)
+			dmi_table_value(dmi_string(h, offset));
+		else
+		{
+			sprintf(buf, "%u", data[4]);	/* count */
+			dmi_table_value(buf);
+		}
+		return;
+	}
+
+	f = dmi_field_at(opt.string->type, offset);
+	if (f == NULL)
+		return;
+
+	value = dmi_field_value(f, h, ver, buf, sizeof(buf));
+	if (value != NULL)
+		dmi_table_value(value);
+}
+
+static void dmi_table_field(const struct dmi_header *h, u16 ver)
+{
+	const char *value;
+	char buf[80];
+
+	value = dmi_field_value(opt.field, h, ver, buf, sizeof(buf));
+	if (value != NULL)
+		dmi_table_value(value);
+}
+
+/* Returns 1 if the structure satisfies all --match conditions */
+static int dmi_table_match(const struct dmi_header *h, u16 ver)
+{
+	unsigned int i;
+
+	for (i = 0; i < opt.match_count; i++)
+	{
+		const struct match_value *m = &opt.match[i];
+		const struct dmi_field *f = m->field;
+		const u8 *p = h->data + f->offset;
+		const char *value;
+		char buf[80];
+
+		if (h->type != f->type || h->length < f->length)
+			return 0;
+
+		if (m->raw)
+		{
+			u32 code = f->width == 1 ? *p :
+				   f->width == 2 ? WORD(p) : DWORD(p);
+
+			if (f->format == FIELD_ENUM)
+				code &= f->values->mask;
+			if (code != m->code)
+				return 0;
+			continue;
+		}
+
+		value = dmi_field_value(f, h, ver, buf, sizeof(buf));
+		if (value == NULL || strcasecmp(value, m->text) != 0)
+			return 0;
+	}
+
+	return 1;
+}
+
+static int dmi_table_dump(const u8 *ep, u32 ep_len, const u8 *table,
+			  u32 table_len, const char *source)
+{
+	int fd;
+	FILE *f;
+
+	if (opt.flags & FLAG_STORE)
+		return dmi_store_write(opt.dumpfile, ep, ep_len, table,
+				       table_len);
+
+	fd = open(opt.dumpfile, O_WRONLY|O_CREAT|O_EXCL, 0666);
+	if (fd == -1)
+	{
+		fprintf(stderr, "%s: ", opt.dumpfile);
+		perror("open");
+		return -1;
+	}
+
+	f = fdopen(fd, "wb");
+	if (!f)
+	{
+		fprintf(stderr, "%s: ", opt.dumpfile);
+		perror("fdopen");
+		return -1;
+	}
+
+	if (!(opt.flags & FLAG_QUIET))
+		pr_comment("Writing %d bytes to %s.", ep_len, opt.dumpfile);
+	if (fwrite(ep, ep_len, 1, f) != 1)
+	{
+		fprintf(stderr, "%s: ", opt.dumpfile);
+		perror("fwrite");
+		goto err_close;
+	}
+
+	if (fseek(f, 32, SEEK_SET) != 0)
+	{
+		fprintf(stderr, "%s: ", opt.dumpfile);
+		perror("fseek");
+		goto err_close;
+	}
+
+	if (!(opt.flags & FLAG_QUIET))
+		pr_comment("Writing %d bytes to %s.", table_len, opt.dumpfile);
+	if (fwrite(table, table_len, 1, f) != 1)
+	{
+		fprintf(stderr, "%s: ", opt.dumpfile);
+		perror("fwrite");
+		goto err_close;
+	}
+
+	if ((opt.flags & FLAG_DUMP_INDEX)
+	 && dmi_dump_index_write(f, opt.dumpfile, 32, table, table_len,
+				 source) != 0)
+		goto err_close;
+
+	if (fclose(f))
+	{
+		fprintf(stderr, "%s: ", opt.dumpfile);
+		perror("fclose");
+		return -1;
+	}
+
+	return 0;
+
+err_close:
+	fclose(f);
+	return -1;
+}
+
+static int dmi_table_display(const struct dmi_header *h)
+{
+	return (opt.type == NULL || opt.type[h->type])
+		&& (opt.handle == ~0U || opt.handle == h->handle)
+		&& !((opt.flags & FLAG_QUIET) && (h->type == 126 || h->type == 127))
+		&& !opt.string && !opt.field;
+}
+
+/*
+ * Second pass: Actually decode the data. Only structures first to last - 1
+ * are decoded; if last is negative, decoding goes on to the end of the table
+ * and the table consistency is checked. Decoding starts at structure first,
+ * which must be in idx if not 0.
+ */
+static void dmi_table_decode_range(u8 *buf, u32 len, u16 num, u16 ver,
+				   u32 flags, const struct dmi_index *idx,
+				   int first, int last)
+{
+	u8 *data;
+	int i = 0;
+
+	/*
+	 * Structures decoded by other workers must not be printed,
+	 * but OEM decoders may need to know they were there.
+	 */
+	for (i = 0; i < first; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+
+		if (dmi_table_display(h) && !(opt.flags & FLAG_DUMP)
+		 && (opt.match_count == 0 || dmi_table_match(h, ver)))
+			dmi_skip_oem(h);
+	}
+
+	data = first ? idx->entry[first].h.data : buf;
 	while ((i < num || !num)
 	    && data + 4 <= buf + len) /* 4 is the length of an SMBIOS structure header */
 	{
 		u8 *next;
 		struct dmi_header h;
-		int display;
+		int display, matched;
+
+		if (last >= 0 && i >= last)
+			return;
 
 		to_dmi_header(&h, data);
-		display = ((opt.type == NULL || opt.type[h.type])
-			&& (opt.handle == ~0U || opt.handle == h.handle)
-			&& !((opt.flags & FLAG_QUIET) && (h.type == 126 || h.type == 127))
-			&& !opt.string);
+		display = dmi_table_display(&h);
 
 		/*
 		 * If a short entry is found (less than 4 bytes), not only it
@@ -5747,10 +6337,6 @@ static void dmi_table_decode(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
 		if ((opt.flags & FLAG_QUIET) && h.type == 127)
 			break;
 
-		if (display
-		 && (!(opt.flags & FLAG_QUIET) || (opt.flags & FLAG_DUMP)))
-			pr_handle(&h);
-
 		/* Look for the next handle */
 		next = data + h.length;
 		while ((unsigned long)(next - buf + 1) < len
@@ -5758,6 +6344,16 @@ static void dmi_table_decode(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
 			next++;
 		next += 2;
 
+		/* Strings are needed to match, so the structure must fit */
+		matched = opt.match_count == 0
+		       || ((unsigned long)(next - buf) <= len
+			&& dmi_table_match(&h, ver));
+		display = display && matched;
+
+		if (display
+		 && (!(opt.flags & FLAG_QUIET) || (opt.flags & FLAG_DUMP)))
+			pr_handle(&h);
+
 		/* Make sure the whole structure fits in the table */
 		if ((unsigned long)(next - buf) > len)
 		{
@@ -5783,8 +6379,11 @@ static void dmi_table_decode(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
 				dmi_decode(&h, ver);
 		}
 		else if (opt.string != NULL
-		      && opt.string->type == h.type)
+		      && opt.string->type == h.type && matched)
 			dmi_table_string(&h, data, ver);
+		else if (opt.field != NULL
+		      && opt.field->type == h.type && matched)
+			dmi_table_field(&h, ver);
 
 		data = next;
 
@@ -5797,7 +6396,7 @@ static void dmi_table_decode(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
 	 * SMBIOS v3 64-bit entry points do not announce a structures count,
 	 * and only indicate a maximum size for the table.
 	 */
-	if (!(opt.flags & FLAG_QUIET))
+	if (last < 0 && !(opt.flags & FLAG_QUIET))
 	{
 		if (num && i != num)
 			fprintf(stderr, "Wrong DMI structures count: %d announced, "
@@ -5810,6 +6409,239 @@ static void dmi_table_decode(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
 	}
 }
 
+/* Append the contents of f to stdout, then close it */
+static void dmi_table_decode_copy(FILE *f)
+{
+	char chunk[4096];
+	size_t n;
+
+	rewind(f);
+	while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+		fwrite(chunk, 1, n, stdout);
+	fclose(f);
+}
+
+/*
+ * Split count items into opt.jobs ranges of consecutive items, each
+ * handled by a child process. The first range goes straight to stdout,
+ * the others to temporary files which are then copied to stdout in
+ * order, so the output is the same as when handling the items serially.
+ * Decoder state is per-process, so the children don't need any locking.
+ * The last range is passed to the job as ending at -1. Returns the first
+ * item which still needs to be handled by the caller (count if none).
+ */
+static int dmi_parallel(int count, void (*job)(int first, int last, void *data),
+			void *data, const char *what)
+{
+	unsigned int jobs = opt.jobs, started, j;
+	int chunk, first;
+	FILE **out;
+	pid_t *pid;
+
+	if ((int)jobs > count)
+		jobs = count;
+	chunk = (count + jobs - 1) / jobs;
+	/* Rounding up may leave the last jobs without items */
+	jobs = (count + chunk - 1) / chunk;
+
+	out = malloc(jobs * sizeof(*out));
+	pid = malloc(jobs * sizeof(*pid));
+	if (out == NULL || pid == NULL)
+	{
+		perror("malloc");
+		free(out);
+		free(pid);
+		return 0;
+	}
+
+	/* Don't let the children inherit pending output */
+	fflush(stdout);
+	fflush(stderr);
+
+	for (started = 0; started < jobs; started++)
+	{
+		first = started * chunk;
+
+		out[started] = NULL;
+		if (started != 0 && (out[started] = tmpfile()) == NULL)
+		{
+			perror("tmpfile");
+			break;
+		}
+
+		pid[started] = fork();
+		if (pid[started] == -1)
+		{
+			perror("fork");
+			if (out[started] != NULL)
+				fclose(out[started]);
+			break;
+		}
+		if (pid[started] == 0)
+		{
+			if (out[started] != NULL
+			 && dup2(fileno(out[started]), STDOUT_FILENO) == -1)
+				_exit(1);
+			job(first, started == jobs - 1 ? -1 : first + chunk,
+			    data);
+			fflush(stdout);
+			_exit(ferror(stdout) ? 1 : 0);
+		}
+	}
+
+	for (j = 0; j < started; j++)
+	{
+		int status;
+
+		/* A closed output pipe isn't worth a message */
+		if (waitpid(pid[j], &status, 0) == -1)
+			perror("waitpid");
+		else if (WIFSIGNALED(status) ? WTERMSIG(status) != SIGPIPE
+					     : WEXITSTATUS(status) != 0)
+			fprintf(stderr, "Decoding of %s %u to %u failed, "
+				"output is incomplete\n", what,
+				j * chunk, j * chunk + chunk - 1);
+		if (out[j] != NULL)
+			dmi_table_decode_copy(out[j]);
+	}
+
+	free(out);
+	free(pid);
+
+	return started == jobs ? count : (int)(started * chunk);
+}
+
+struct dmi_decode_job
+{
+	u8 *buf;
+	u32 len;
+	u16 num;
+	u16 ver;
+	u32 flags;
+	const struct dmi_index *idx;
+};
+
+static void dmi_table_decode_job(int first, int last, void *data)
+{
+	const struct dmi_decode_job *d = data;
+
+	dmi_table_decode_range(d->buf, d->len, d->num, d->ver, d->flags,
+			       d->idx, first, last);
+}
+
+static void dmi_table_decode(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+	u8 *data;
+	int i = 0, first = 0;
+
+	/* First pass: Save specific values needed to decode OEM types */
+	data = buf;
+	while ((i < num || !num)
+	    && data + 4 <= buf + len) /* 4 is the length of an SMBIOS structure header */
+	{
+		u8 *next;
+		struct dmi_header h;
+
+		to_dmi_header(&h, data);
+
+		/*
+		 * If a short entry is found (less than 4 bytes), not only it
+		 * is invalid, but we cannot reliably locate the next entry.
+		 * Also stop at end-of-table marker if so instructed.
+		 */
+		if (h.length < 4 ||
+		    (h.type == 127 &&
+		     (opt.flags & (FLAG_QUIET | FLAG_STOP_AT_EOT))))
+			break;
+		i++;
+
+		/* Look for the next handle */
+		next = data + h.length;
+		while ((unsigned long)(next - buf + 1) < len
+		    && (next[0] != 0 || next[1] != 0))
+			next++;
+		next += 2;
+
+		/* Make sure the whole structure fits in the table */
+		if ((unsigned long)(next - buf) > len)
+			break;
+
+		/* Assign vendor for vendor-specific decodes later */
+		if (h.type == 1 && h.length >= 6)
+			dmi_set_vendor(_dmi_string(&h, data[0x04], 0),
+				       _dmi_string(&h, data[0x05], 0));
+
+		/* Remember CPUID type for HPE type 199 */
+		if (h.type == 4 && h.length >= 0x1A && cpuid_type == cpuid_none)
+			cpuid_type = dmi_get_cpuid_type(&h);
+		data = next;
+	}
+
+	/* Values are the elements of an array in JSON */
+	if (opt.flags & FLAG_JSON)
+	{
+		dmi_value_count = 0;
+		printf("[");
+	}
+
+	/*
+	 * Second pass: Actually decode the data. Workers are given the
+	 * location of their first structure, so that they don't need to
+	 * walk the table up to there. The index stops where decoding would.
+	 * JSON array elements must know if they are the first one, so they
+	 * are not handled by workers.
+	 */
+	if (opt.jobs > 1 && i > 1 && !(opt.flags & FLAG_JSON)
+	 && dmi_index_build(&idx, buf, len, num,
+			    (flags & FLAG_STOP_AT_EOT)
+			    || (opt.flags & FLAG_QUIET)) == 0)
+	{
+		struct dmi_decode_job job = { buf, len, num, ver, flags, &idx };
+
+		if (idx.count > 1)
+			first = dmi_parallel(idx.count, dmi_table_decode_job,
+					     &job, "structures");
+		if (first == (int)idx.count)
+		{
+			dmi_index_free(&idx);
+			return;
+		}
+	}
+	dmi_table_decode_range(buf, len, num, ver, flags, &idx, first, -1);
+	dmi_index_free(&idx);
+
+	if (opt.flags & FLAG_JSON)
+		printf("%s]\n", dmi_value_count ? "\n" : "");
+}
+
+/*
+ * Copy a chunk of an in-memory dump image, with the same semantics as
+ * read_file(). This function allocates memory.
+ */
+static u8 *dmi_image_chunk(const u8 *image, size_t image_len, off_t base,
+			   size_t *len)
+{
+	u8 *p;
+
+	if (base < 0 || (size_t)base >= image_len)
+	{
+		fprintf(stderr, "Can't read data beyond end of image\n");
+		return NULL;
+	}
+	if (*len > image_len - base)
+		*len = image_len - base;
+
+	if ((p = malloc(*len)) == NULL)
+	{
+		perror("malloc");
+		return NULL;
+	}
+	memcpy(p, image + base, *len);
+
+	return p;
+}
+
 /* Allocates a buffer for the table, must be freed by the caller */
 static u8 *dmi_table_get(off_t base, u32 *len, u16 num, u32 ver,
 			 const char *devmem, u32 flags)
@@ -5850,8 +6682,12 @@ static u8 *dmi_table_get(off_t base, u32 *len, u16 num, u32 ver,
 		 * parse error.
 		 */
 		size_t size = *len;
-		buf = read_file(flags & FLAG_NO_FILE_OFFSET ? 0 : base,
-			&size, devmem);
+		if (dump_image != NULL)
+			buf = dmi_image_chunk(dump_image, dump_image_len,
+					      base, &size);
+		else
+			buf = read_file(flags & FLAG_NO_FILE_OFFSET ? 0 : base,
+				&size, devmem);
 		if (!(opt.flags & FLAG_QUIET) && num && size != (size_t)*len)
 		{
 			fprintf(stderr, "Wrong DMI structures length: %u bytes "
@@ -5891,19 +6727,320 @@ static void overwrite_dmi_address(u8 *buf)
 	buf[0x0B] = 0;
 }
 
-/* Same thing for SMBIOS3 entry points */
-static void overwrite_smbios3_address(u8 *buf)
-{
-	buf[0x05] += buf[0x10] + buf[0x11] + buf[0x12] + buf[0x13]
-		   + buf[0x14] + buf[0x15] + buf[0x16] + buf[0x17] - 32;
-	buf[0x10] = 32;
-	buf[0x11] = 0;
-	buf[0x12] = 0;
-	buf[0x13] = 0;
-	buf[0x14] = 0;
-	buf[0x15] = 0;
-	buf[0x16] = 0;
-	buf[0x17] = 0;
+/* Same thing for SMBIOS3 entry points */
+static void overwrite_smbios3_address(u8 *buf)
+{
+	buf[0x05] += buf[0x10] + buf[0x11] + buf[0x12] + buf[0x13]
+		   + buf[0x14] + buf[0x15] + buf[0x16] + buf[0x17] - 32;
+	buf[0x10] = 32;
+	buf[0x11] = 0;
+	buf[0x12] = 0;
+	buf[0x13] = 0;
+	buf[0x14] = 0;
+	buf[0x15] = 0;
+	buf[0x16] = 0;
+	buf[0x17] = 0;
+}
+
+/*
+ * When an index follows the table, the maximum table length must not
+ * cover it, so set it to the actual table length.
+ */
+static void overwrite_smbios3_length(u8 *buf, u32 len)
+{
+	buf[0x05] += buf[0x0C] + buf[0x0D] + buf[0x0E] + buf[0x0F]
+		   - (u8)len - (u8)(len >> 8) - (u8)(len >> 16) - (u8)(len >> 24);
+	buf[0x0C] = len;
+	buf[0x0D] = len >> 8;
+	buf[0x0E] = len >> 16;
+	buf[0x0F] = len >> 24;
+}
+
+static int dmi_decode_dump(const char *filename, int *found);
+
+/*
+ * Compare the table with the reference dump given with --diff. The dump
+ * is read like with --from-dump, but quietly, and kept instead of being
+ * processed.
+ */
+static void dmi_table_diff(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
+{
+	struct dmi_index ref_idx = { NULL, 0, NULL };
+	struct dmi_index idx = { NULL, 0, NULL };
+	struct kept_table ref;
+	u32 saved_flags = opt.flags;
+	int found = 0;
+
+	opt.flags |= FLAG_QUIET | FLAG_FROM_DUMP;
+	keep_table = 1;
+	if (dmi_decode_dump(opt.diff, &found) >= 0 && !found)
+		fprintf(stderr, "%s: No valid entry point found.\n", opt.diff);
+	keep_table = 0;
+	opt.flags = saved_flags;
+
+	ref = kept_table;
+	kept_table.table = NULL;
+	if (ref.table == NULL)
+		return;
+
+	if (!(opt.flags & FLAG_QUIET))
+	{
+		pr_info("Comparing with SMBIOS %u.%u data from file %s.",
+			ref.ver >> 8, ref.ver & 0xFF, opt.diff);
+		pr_sep();
+	}
+
+	if (dmi_index_build(&ref_idx, ref.table, ref.len, ref.num,
+			    ref.flags & FLAG_STOP_AT_EOT) == 0
+	 && dmi_index_build(&idx, buf, len, num,
+			    flags & FLAG_STOP_AT_EOT) == 0)
+		dmi_diff(&ref_idx, ref.ver, &idx, ver);
+
+	dmi_index_free(&ref_idx);
+	dmi_index_free(&idx);
+	free(ref.table);
+}
+
+static void dmi_table_fingerprint(u8 *buf, u32 len, u16 num, u32 flags)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+
+	if (dmi_index_build(&idx, buf, len, num, flags & FLAG_STOP_AT_EOT) == 0)
+		dmi_fingerprint(&idx);
+	dmi_index_free(&idx);
+}
+
+static void dmi_table_csv(u8 *buf, u32 len, u16 num, u16 ver, u32 flags,
+			  const char *source)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+	unsigned int i;
+
+	if (dmi_index_build(&idx, buf, len, num, flags & FLAG_STOP_AT_EOT) == 0)
+	{
+		for (i = 0; i < idx.count; i++)
+		{
+			const struct dmi_header *h = &idx.entry[i].h;
+
+			if (h->type == opt.csv_type && dmi_table_match(h, ver))
+				dmi_csv_row(source, h, ver);
+		}
+	}
+	dmi_index_free(&idx);
+}
+
+static void dmi_table_export(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+
+	if (dmi_index_build(&idx, buf, len, num, flags & FLAG_STOP_AT_EOT) == 0)
+		dmi_export(&idx, ver);
+	dmi_index_free(&idx);
+}
+
+static void dmi_table_prometheus(u8 *buf, u32 len, u16 num, u16 ver,
+				 u32 flags)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+
+	if (!(opt.flags & FLAG_QUIET))
+		pr_comment("Writing metrics to %s.", opt.prometheus);
+	if (dmi_index_build(&idx, buf, len, num, flags & FLAG_STOP_AT_EOT) == 0)
+		dmi_prometheus_write(opt.prometheus, &idx, ver);
+	dmi_index_free(&idx);
+}
+
+static void dmi_table_locate(u8 *buf, u32 len, u16 num, u32 flags)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+
+	if (dmi_index_build(&idx, buf, len, num, flags & FLAG_STOP_AT_EOT) == 0)
+		dmi_locate(&idx);
+	dmi_index_free(&idx);
+}
+
+static void dmi_table_summary(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+
+	if (dmi_index_build(&idx, buf, len, num, flags & FLAG_STOP_AT_EOT) == 0)
+		dmi_summary(&idx, ver);
+	dmi_index_free(&idx);
+}
+
+static void dmi_table_tree(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+
+	if (dmi_index_build(&idx, buf, len, num, flags & FLAG_STOP_AT_EOT) == 0)
+		dmi_tree(&idx, ver);
+	dmi_index_free(&idx);
+}
+
+static void dmi_table_pci_map(u8 *buf, u32 len, u16 num, u16 ver,
+			      u32 flags)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+
+	if (dmi_index_build(&idx, buf, len, num, flags & FLAG_STOP_AT_EOT) == 0)
+		dmi_pci_map(&idx, ver);
+	dmi_index_free(&idx);
+}
+
+static void dmi_table_oem_keys(u8 *buf, u32 len, u16 num, u32 flags)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+
+	if (dmi_index_build(&idx, buf, len, num, flags & FLAG_STOP_AT_EOT) == 0)
+		dmi_oem_keys(&idx);
+	dmi_index_free(&idx);
+}
+
+/*
+ * Stop at the first entry of the given type, so that the rest of the
+ * table is not even walked. Returns 0 if there is none.
+ */
+static int dmi_table_first(u8 *buf, u32 len, u16 num, u32 flags, u8 type,
+			   struct dmi_header *h)
+{
+	u8 *data = buf, *next;
+	int i = 0;
+
+	while ((i++ < num || !num)
+	    && data + 4 <= buf + len) /* 4 is the length of an SMBIOS structure header */
+	{
+		if (data[1] < 4)
+			break;
+
+		/* Look for the next handle */
+		next = data + data[1];
+		while ((unsigned long)(next - buf + 1) < len
+		    && (next[0] != 0 || next[1] != 0))
+			next++;
+		next += 2;
+
+		/* Make sure the whole structure fits in the table */
+		if ((unsigned long)(next - buf) > len)
+			break;
+
+		if (data[0] == type)
+		{
+			to_dmi_header(h, data);
+			return 1;
+		}
+		if (data[0] == 127 && (flags & FLAG_STOP_AT_EOT))
+			break;
+		data = next;
+	}
+	return 0;
+}
+
+static void dmi_table_ipmi(u8 *buf, u32 len, u16 num, u32 flags)
+{
+	struct dmi_header h;
+
+	dmi_ipmi(dmi_table_first(buf, len, num, flags, 38, &h) ? &h : NULL);
+}
+
+static void dmi_table_redfish(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+
+	if (dmi_index_build(&idx, buf, len, num, flags & FLAG_STOP_AT_EOT) == 0)
+		dmi_redfish(&idx, ver);
+	dmi_index_free(&idx);
+}
+
+static void dmi_table_event_log(u8 *buf, u32 len, u16 num, u32 flags)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+
+	if (dmi_index_build(&idx, buf, len, num, flags & FLAG_STOP_AT_EOT) == 0)
+		dmi_event_log(&idx);
+	dmi_index_free(&idx);
+}
+
+static void dmi_table_format(u8 *buf, u32 len, u16 num, u16 ver, u32 flags)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+	unsigned int i;
+
+	if (dmi_index_build(&idx, buf, len, num, flags & FLAG_STOP_AT_EOT) == 0)
+	{
+		if (opt.format_type == -1)
+			dmi_format_print(&idx, NULL, ver);
+		for (i = 0; opt.format_type != -1 && i < idx.count; i++)
+		{
+			const struct dmi_header *h = &idx.entry[i].h;
+
+			if (h->type == opt.format_type && dmi_table_match(h, ver))
+				dmi_format_print(&idx, h, ver);
+		}
+	}
+	dmi_index_free(&idx);
+}
+
+/*
+ * Everything but --dump-bin goes through here, once the table was read
+ */
+static void dmi_table_process(u8 *buf, u32 len, u16 num, u16 ver, u32 flags,
+			      const char *source)
+{
+	/* Keep a copy of the table, it is processed later */
+	if (keep_table && kept_table.table == NULL)
+	{
+		if ((kept_table.table = malloc(len ? len : 1)) == NULL)
+		{
+			perror("malloc");
+			return;
+		}
+		memcpy(kept_table.table, buf, len);
+		kept_table.len = len;
+		kept_table.num = num;
+		kept_table.ver = ver;
+		kept_table.flags = flags;
+		kept_table.source = source;
+		return;
+	}
+
+	if (opt.publish != NULL)
+	{
+		if (!(opt.flags & FLAG_QUIET))
+			pr_comment("Publishing table to shared memory %s.",
+				   opt.publish);
+		dmi_shm_publish(opt.publish, buf, len, num, ver,
+				flags & FLAG_STOP_AT_EOT);
+	}
+	else if (opt.diff != NULL)
+		dmi_table_diff(buf, len, num, ver, flags);
+	else if (opt.flags & FLAG_FINGERPRINT)
+		dmi_table_fingerprint(buf, len, num, flags);
+	else if (opt.flags & FLAG_CSV)
+		dmi_table_csv(buf, len, num, ver, flags, source);
+	else if (opt.flags & FLAG_EXPORT)
+		dmi_table_export(buf, len, num, ver, flags);
+	else if (opt.flags & FLAG_FORMAT)
+		dmi_table_format(buf, len, num, ver, flags);
+	else if (opt.prometheus != NULL)
+		dmi_table_prometheus(buf, len, num, ver, flags);
+	else if (opt.flags & FLAG_LOCATE)
+		dmi_table_locate(buf, len, num, flags);
+	else if (opt.summary)
+		dmi_table_summary(buf, len, num, ver, flags);
+	else if (opt.flags & FLAG_TREE)
+		dmi_table_tree(buf, len, num, ver, flags);
+	else if (opt.flags & FLAG_PCI_MAP)
+		dmi_table_pci_map(buf, len, num, ver, flags);
+	else if (opt.oem_key_count)
+		dmi_table_oem_keys(buf, len, num, flags);
+	else if (opt.flags & FLAG_EVENT_LOG)
+		dmi_table_event_log(buf, len, num, flags);
+	else if (opt.flags & FLAG_REDFISH)
+		dmi_table_redfish(buf, len, num, ver, flags);
+	else if (opt.flags & FLAG_IPMI)
+		dmi_table_ipmi(buf, len, num, flags);
+	else
+		dmi_table_decode(buf, len, num, ver, flags);
 }
 
 static int smbios3_decode(u8 *buf, size_t buf_len, const char *devmem, u32 flags)
@@ -5950,13 +7087,15 @@ static int smbios3_decode(u8 *buf, size_t buf_len, const char *devmem, u32 flags
 
 		memcpy(crafted, buf, 32);
 		overwrite_smbios3_address(crafted);
+		if (opt.flags & FLAG_DUMP_INDEX)
+			overwrite_smbios3_length(crafted, len);
 
-		dmi_table_dump(crafted, crafted[0x06], table, len);
+		dmi_table_dump(crafted, crafted[0x06], table, len, devmem);
 	}
 	else
 	{
-		dmi_table_decode(table, len, 0, ver >> 8,
-				 flags | FLAG_STOP_AT_EOT);
+		dmi_table_process(table, len, 0, ver >> 8,
+				  flags | FLAG_STOP_AT_EOT, devmem);
 	}
 
 	free(table);
@@ -6034,11 +7173,11 @@ static int smbios_decode(u8 *buf, size_t buf_len, const char *devmem, u32 flags)
 		memcpy(crafted, buf, 32);
 		overwrite_dmi_address(crafted + 0x10);
 
-		dmi_table_dump(crafted, crafted[0x05], table, len);
+		dmi_table_dump(crafted, crafted[0x05], table, len, devmem);
 	}
 	else
 	{
-		dmi_table_decode(table, len, num, ver, flags);
+		dmi_table_process(table, len, num, ver, flags, devmem);
 	}
 
 	free(table);
@@ -6075,11 +7214,11 @@ static int legacy_decode(u8 *buf, const char *devmem, u32 flags)
 		memcpy(crafted, buf, 16);
 		overwrite_dmi_address(crafted);
 
-		dmi_table_dump(crafted, 0x0F, table, len);
+		dmi_table_dump(crafted, 0x0F, table, len, devmem);
 	}
 	else
 	{
-		dmi_table_decode(table, len, num, ver, flags);
+		dmi_table_process(table, len, num, ver, flags, devmem);
 	}
 
 	free(table);
@@ -6167,96 +7306,224 @@ static int address_from_efi(off_t *address)
 	return ret;
 }
 
-int main(int argc, char * const argv[])
+/*
+ * Read and decode the table from a dump file or store record. Returns -1 if
+ * the file can't be read, 1 if the entry point is truncated, 0 otherwise,
+ * and increments found if a valid entry point was found.
+ */
+static int dmi_decode_dump(const char *filename, int *found)
 {
-	int ret = 0;                /* Returned value */
-	int found = 0;
-	off_t fp;
-	size_t size;
-	int efi;
-	u8 *buf = NULL;
+	size_t size = 0x20;
+	int ret = 0;
+	u8 *buf;
 
-	/*
-	 * We don't want stdout and stderr to be mixed up if both are
-	 * redirected to the same file.
-	 */
-	setlinebuf(stdout);
-	setlinebuf(stderr);
+	if (!(opt.flags & FLAG_QUIET))
+		pr_info("Reading SMBIOS/DMI data from file %s.", filename);
+	if ((buf = read_file(0, &size, filename)) == NULL)
+		return -1;
 
-	if (sizeof(u8) != 1 || sizeof(u16) != 2 || sizeof(u32) != 4 || '\0' != 0)
+	/* Store records are rebuilt in memory, then read from there */
+	if (size >= 8 && memcmp(buf, STORE_MAGIC, 8) == 0)
 	{
-		fprintf(stderr, "%s: compiler incompatibility\n", argv[0]);
-		exit(255);
+		free(buf);
+		if ((buf = dmi_store_read(filename, &size)) == NULL)
+			return -1;
+		dump_image = buf;
+		dump_image_len = size;
 	}
+	else if (!(opt.flags & FLAG_QUIET))
+		dmi_dump_index_print(filename);
 
-	/* Set default option values */
-	opt.devmem = DEFAULT_MEM_DEV;
-	opt.flags = 0;
-	opt.handle = ~0U;
+	/* Truncated entry point can't be processed */
+	if (size < 0x20)
+		ret = 1;
+	else if (memcmp(buf, "_SM3_", 5) == 0)
+	{
+		if (smbios3_decode(buf, size, filename, 0))
+			(*found)++;
+	}
+	else if (memcmp(buf, "_SM_", 4) == 0)
+	{
+		if (smbios_decode(buf, size, filename, 0))
+			(*found)++;
+	}
+	else if (memcmp(buf, "_DMI_", 5) == 0)
+	{
+		if (legacy_decode(buf, filename, 0))
+			(*found)++;
+	}
 
-	if (parse_command_line(argc, argv)<0)
+	dump_image = NULL;
+	free(buf);
+	return ret;
+}
+
+/*
+ * Read and decode the table published in shared memory by --publish.
+ * Returns 0 on success, -1 on error.
+ */
+static int dmi_decode_shm(const char *name)
+{
+	u8 *table;
+	u32 len;
+	u16 num, ver;
+	int stop_at_eot;
+
+	if (!(opt.flags & FLAG_QUIET))
+		pr_info("Reading SMBIOS/DMI data from shared memory %s.", name);
+	if ((table = dmi_shm_read(name, &len, &num, &ver, &stop_at_eot)) == NULL)
+		return -1;
+
+	if (!(opt.flags & FLAG_QUIET))
 	{
-		ret = 2;
-		goto exit_free;
+		pr_info("SMBIOS %u.%u present.", ver >> 8, ver & 0xFF);
+		if (opt.type == NULL && num)
+			pr_info("%u structures occupying %u bytes.", num, len);
+		pr_sep();
 	}
 
-	if (opt.flags & FLAG_LIST)
+	dmi_table_process(table, len, num, ver,
+			  stop_at_eot ? FLAG_STOP_AT_EOT : 0, name);
+	free(table);
+	return 0;
+}
+
+/*
+ * Read and decode the table from sysfs. Returns -1 if the entry point
+ * can't be read, 0 otherwise, and increments found if a valid entry point
+ * was found.
+ */
+static int dmi_decode_sysfs(int *found)
+{
+	size_t size = 0x20;
+	int ok = 0;
+	u8 *buf;
+
+	if ((buf = read_file(0, &size, SYS_ENTRY_FILE)) == NULL)
+		return -1;
+
+	if (!(opt.flags & FLAG_QUIET))
+		pr_info("Getting SMBIOS data from sysfs.");
+	if (size >= 24 && memcmp(buf, "_SM3_", 5) == 0)
+		ok = smbios3_decode(buf, size, SYS_TABLE_FILE, FLAG_NO_FILE_OFFSET);
+	else if (size >= 31 && memcmp(buf, "_SM_", 4) == 0)
+		ok = smbios_decode(buf, size, SYS_TABLE_FILE, FLAG_NO_FILE_OFFSET);
+	else if (size >= 15 && memcmp(buf, "_DMI_", 5) == 0)
+		ok = legacy_decode(buf, SYS_TABLE_FILE, FLAG_NO_FILE_OFFSET);
+
+	if (ok)
+		(*found)++;
+
+	/* Remember the entry point, so that the daemon can detect changes */
+	if (ok && kept_table.table != NULL)
 	{
-		/* Already handled in parse_command_line() */
-		goto exit_free;
+		memcpy(kept_table.ep, buf, size);
+		kept_table.ep_len = size;
 	}
 
-	if (opt.flags & FLAG_HELP)
+	free(buf);
+	return 0;
+}
+
+/*
+ * If the table was read from sysfs, read it again if the entry point
+ * changed. The previous table is kept if the new one can't be read.
+ */
+static void dmi_daemon_refresh(void)
+{
+	u8 *buf, *table;
+	size_t size = 0x20;
+	int found = 0, changed;
+
+	if (kept_table.ep_len == 0
+	 || (buf = read_file(0, &size, SYS_ENTRY_FILE)) == NULL)
+		return;
+	changed = size != kept_table.ep_len
+		|| memcmp(buf, kept_table.ep, size) != 0;
+	free(buf);
+	if (!changed)
+		return;
+
+	if (!(opt.flags & FLAG_QUIET))
+		pr_info("Entry point changed, reading table again.");
+	table = kept_table.table;
+	kept_table.table = NULL;
+	if (dmi_decode_sysfs(&found) == 0 && kept_table.table != NULL)
 	{
-		print_help();
-		goto exit_free;
+		free(table);
+		return;
 	}
 
-	if (opt.flags & FLAG_VERSION)
+	fprintf(stderr, "Failed to read table again, keeping the previous one\n");
+	kept_table.table = table;
+}
+
+static void dmi_daemon_query(void)
+{
+	dmi_table_process(kept_table.table, kept_table.len,
+			  kept_table.num, kept_table.ver, kept_table.flags,
+			  kept_table.source);
+}
+
+static void dmi_csv_file_job(int first, int last, void *data)
+{
+	int i, found;
+
+	(void)data;
+	if (last == -1)
+		last = opt.file_count;
+
+	for (i = first; i < last; i++)
 	{
-		printf("%s\n", VERSION);
-		goto exit_free;
+		found = 0;
+		if (dmi_decode_dump(opt.files[i], &found) < 0)
+			fprintf(stderr, "%s: Can't read file, skipped\n",
+				opt.files[i]);
+		else if (!found)
+			fprintf(stderr, "%s: No SMBIOS nor DMI entry point found, "
+				"skipped\n", opt.files[i]);
 	}
+}
 
-	if (!(opt.flags & FLAG_QUIET))
-		pr_comment("dmidecode %s", VERSION);
+/*
+ * Export the entries of the type given to --csv from a list of dump files.
+ * Files which can't be read are reported and skipped.
+ */
+static void dmi_csv_files(void)
+{
+	int first = 0;
+
+	/* Tables are read from the files, like with --from-dump */
+	opt.flags |= FLAG_FROM_DUMP;
+	if (opt.jobs > 1 && opt.file_count > 1)
+		first = dmi_parallel(opt.file_count, dmi_csv_file_job, NULL,
+				     "dump files");
+	if (first < opt.file_count)
+		dmi_csv_file_job(first, -1, NULL);
+}
+
+/*
+ * Read the table from the requested source, or else from the first one
+ * available, and process it. Returns -1 if no table could be read, 1 if
+ * the entry point is truncated, 0 otherwise, and increments found if a
+ * valid entry point was found.
+ */
+static int dmi_read_table(int *found)
+{
+	off_t fp;
+	int efi;
+	u8 *buf = NULL;
 
 	/* Read from dump if so instructed */
-	size = 0x20;
 	if (opt.flags & FLAG_FROM_DUMP)
-	{
-		if (!(opt.flags & FLAG_QUIET))
-			pr_info("Reading SMBIOS/DMI data from file %s.",
-				opt.dumpfile);
-		if ((buf = read_file(0, &size, opt.dumpfile)) == NULL)
-		{
-			ret = 1;
-			goto exit_free;
-		}
-
-		/* Truncated entry point can't be processed */
-		if (size < 0x20)
-		{
-			ret = 1;
-			goto done;
-		}
+		return dmi_decode_dump(opt.fromfile, found);
 
-		if (memcmp(buf, "_SM3_", 5) == 0)
-		{
-			if (smbios3_decode(buf, size, opt.dumpfile, 0))
-				found++;
-		}
-		else if (memcmp(buf, "_SM_", 4) == 0)
-		{
-			if (smbios_decode(buf, size, opt.dumpfile, 0))
-				found++;
-		}
-		else if (memcmp(buf, "_DMI_", 5) == 0)
-		{
-			if (legacy_decode(buf, opt.dumpfile, 0))
-				found++;
-		}
-		goto done;
+	if (opt.fromshm != NULL)
+	{
+		if (dmi_decode_shm(opt.fromshm) != 0)
+			return -1;
+		(*found)++;
+		return 0;
 	}
 
 	/*
@@ -6264,29 +7531,10 @@ int main(int argc, char * const argv[])
 	 * contain one of several types of entry points, so read enough for
 	 * the largest one, then determine what type it contains.
 	 */
-	if (!(opt.flags & FLAG_NO_SYSFS)
-	 && (buf = read_file(0, &size, SYS_ENTRY_FILE)) != NULL)
+	if (!(opt.flags & FLAG_NO_SYSFS) && dmi_decode_sysfs(found) == 0)
 	{
-		if (!(opt.flags & FLAG_QUIET))
-			pr_info("Getting SMBIOS data from sysfs.");
-		if (size >= 24 && memcmp(buf, "_SM3_", 5) == 0)
-		{
-			if (smbios3_decode(buf, size, SYS_TABLE_FILE, FLAG_NO_FILE_OFFSET))
-				found++;
-		}
-		else if (size >= 31 && memcmp(buf, "_SM_", 4) == 0)
-		{
-			if (smbios_decode(buf, size, SYS_TABLE_FILE, FLAG_NO_FILE_OFFSET))
-				found++;
-		}
-		else if (size >= 15 && memcmp(buf, "_DMI_", 5) == 0)
-		{
-			if (legacy_decode(buf, SYS_TABLE_FILE, FLAG_NO_FILE_OFFSET))
-				found++;
-		}
-
-		if (found)
-			goto done;
+		if (*found)
+			return 0;
 		if (!(opt.flags & FLAG_QUIET))
 			pr_info("Failed to get SMBIOS data from sysfs.");
 	}
@@ -6298,30 +7546,26 @@ int main(int argc, char * const argv[])
 		case EFI_NOT_FOUND:
 			goto memory_scan;
 		case EFI_NO_SMBIOS:
-			ret = 1;
-			goto exit_free;
+			return -1;
 	}
 
 	if (!(opt.flags & FLAG_QUIET))
 		pr_info("Found SMBIOS entry point in EFI, reading table from %s.",
 			opt.devmem);
 	if ((buf = mem_chunk(fp, 0x20, opt.devmem)) == NULL)
-	{
-		ret = 1;
-		goto exit_free;
-	}
+		return -1;
 
 	if (memcmp(buf, "_SM3_", 5) == 0)
 	{
 		if (smbios3_decode(buf, 0x20, opt.devmem, 0))
-			found++;
+			(*found)++;
 	}
 	else if (memcmp(buf, "_SM_", 4) == 0)
 	{
 		if (smbios_decode(buf, 0x20, opt.devmem, 0))
-			found++;
+			(*found)++;
 	}
-	goto done;
+	goto out;
 
 memory_scan:
 #if defined __i386__ || defined __x86_64__
@@ -6329,10 +7573,7 @@ int main(int argc, char * const argv[])
 		pr_info("Scanning %s for entry point.", opt.devmem);
 	/* Fallback to memory scan (x86, x86_64) */
 	if ((buf = mem_chunk(0xF0000, 0x10000, opt.devmem)) == NULL)
-	{
-		ret = 1;
-		goto exit_free;
-	}
+		return -1;
 
 	/* Look for a 64-bit entry point first */
 	for (fp = 0; fp <= 0xFFE0; fp += 16)
@@ -6341,8 +7582,8 @@ int main(int argc, char * const argv[])
 		{
 			if (smbios3_decode(buf + fp, 0x20, opt.devmem, 0))
 			{
-				found++;
-				goto done;
+				(*found)++;
+				goto out;
 			}
 		}
 	}
@@ -6354,28 +7595,190 @@ int main(int argc, char * const argv[])
 		{
 			if (smbios_decode(buf + fp, 0x20, opt.devmem, 0))
 			{
-				found++;
-				goto done;
+				(*found)++;
+				goto out;
 			}
 		}
 		else if (memcmp(buf + fp, "_DMI_", 5) == 0)
 		{
 			if (legacy_decode(buf + fp, opt.devmem, 0))
 			{
-				found++;
-				goto done;
+				(*found)++;
+				goto out;
 			}
 		}
 	}
 #endif
 
-done:
+out:
+	free(buf);
+	return 0;
+}
+
+/*
+ * Read the table again every opt.watch seconds, and display the
+ * differences with the previous one when it changed. Never returns.
+ */
+static void dmi_watch(void)
+{
+	struct dmi_index old_idx, new_idx;
+	struct kept_table old;
+	unsigned long long hash, new_hash;
+	char date[32];
+	time_t now;
+	int found, failed = 0;
+
+	hash = hash64(kept_table.table, kept_table.len, HASH64_INIT);
+
+	/* Only the changes are displayed from now on */
+	opt.flags |= FLAG_QUIET;
+	for (;;)
+	{
+		fflush(stdout);
+		sleep(opt.watch);
+
+		old = kept_table;
+		kept_table.table = NULL;
+		found = 0;
+		if (dmi_read_table(&found) != 0 || kept_table.table == NULL)
+		{
+			/* Only report the first of consecutive failures */
+			if (!failed)
+				fprintf(stderr, "Failed to read table again, "
+					"keeping the previous one\n");
+			failed = 1;
+			kept_table = old;
+			continue;
+		}
+		failed = 0;
+
+		/*
+		 * Most of the time, this is all there is to do. The hash
+		 * tells quickly if the table changed, the tables are compared
+		 * to make sure that it didn't.
+		 */
+		new_hash = hash64(kept_table.table, kept_table.len, HASH64_INIT);
+		if (new_hash == hash && kept_table.len == old.len
+		 && memcmp(kept_table.table, old.table, old.len) == 0)
+		{
+			free(kept_table.table);
+			kept_table = old;
+			continue;
+		}
+
+		now = time(NULL);
+		if (strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ",
+			     gmtime(&now)) == 0)
+			date[0] = '\0';
+		pr_comment("Table changed at %s", date);
+
+		memset(&old_idx, 0, sizeof(old_idx));
+		memset(&new_idx, 0, sizeof(new_idx));
+		if (dmi_index_build(&old_idx, old.table, old.len, old.num,
+				    old.flags & FLAG_STOP_AT_EOT) == 0
+		 && dmi_index_build(&new_idx, kept_table.table, kept_table.len,
+				    kept_table.num,
+				    kept_table.flags & FLAG_STOP_AT_EOT) == 0)
+			dmi_diff(&old_idx, old.ver, &new_idx, kept_table.ver);
+		pr_sep();
+		dmi_index_free(&old_idx);
+		dmi_index_free(&new_idx);
+
+		free(old.table);
+		hash = new_hash;
+	}
+}
+
+int main(int argc, char * const argv[])
+{
+	int ret = 0;                /* Returned value */
+	int found = 0;
+
+	/*
+	 * We don't want stdout and stderr to be mixed up if both are
+	 * redirected to the same file.
+	 */
+	setlinebuf(stdout);
+	setlinebuf(stderr);
+
+	if (sizeof(u8) != 1 || sizeof(u16) != 2 || sizeof(u32) != 4 || '\0' != 0)
+	{
+		fprintf(stderr, "%s: compiler incompatibility\n", argv[0]);
+		exit(255);
+	}
+
+	/* Set default option values */
+	opt.devmem = DEFAULT_MEM_DEV;
+	opt.flags = 0;
+	opt.handle = ~0U;
+
+	if (parse_command_line(argc, argv)<0)
+	{
+		ret = 2;
+		goto exit_free;
+	}
+
+	if (opt.flags & FLAG_LIST)
+	{
+		/* Already handled in parse_command_line() */
+		goto exit_free;
+	}
+
+	if (opt.flags & FLAG_HELP)
+	{
+		print_help();
+		goto exit_free;
+	}
+
+	if (opt.flags & FLAG_VERSION)
+	{
+		printf("%s\n", VERSION);
+		goto exit_free;
+	}
+
+	if (!(opt.flags & FLAG_QUIET))
+		pr_comment("dmidecode %s", VERSION);
+
+	if (opt.flags & FLAG_CSV)
+	{
+		dmi_csv_header(opt.csv_type);
+		if (opt.file_count)
+		{
+			dmi_csv_files();
+			goto exit_free;
+		}
+	}
+
+	/* Daemon and watch modes process the table later */
+	keep_table = opt.daemon != NULL || opt.watch;
+	ret = dmi_read_table(&found);
+	if (ret < 0)
+	{
+		ret = 1;
+		goto exit_free;
+	}
+
 	if (!found && !(opt.flags & FLAG_QUIET))
 		pr_comment("No SMBIOS nor DMI entry point found, sorry.");
 
-	free(buf);
+	if (opt.watch && kept_table.table != NULL)
+		dmi_watch();
+
+	if (opt.daemon != NULL)
+	{
+		if (kept_table.table == NULL
+		 || dmi_daemon(opt.daemon, dmi_daemon_refresh,
+			       dmi_daemon_query) != 0)
+			ret = 1;
+		free(kept_table.table);
+	}
 exit_free:
 	free(opt.type);
+	free(opt.match);
+	free(opt.format);
+	free(opt.format_buf);
+	free(opt.locate);
+	free(opt.oem_key);
 
 	return ret;
 }
@@ -21,6 +21,8 @@
 #ifndef DMIDECODE_H
 #define DMIDECODE_H
 
+#include <stddef.h>
+
 #include "types.h"
 
 #define out_of_spec "<OUT OF SPEC>"
@@ -47,10 +49,112 @@ enum cpuid_type
 
 extern enum cpuid_type cpuid_type;
 
+/*
+ * Enumerated values
+ */
+
+struct dmi_enum_range
+{
+	u8 first;		/* Code of names[0] */
+	u8 count;
+	const char * const *names;
+};
+
+struct dmi_enum
+{
+	u8 mask;		/* Applied to the code before lookup */
+	struct dmi_enum_range range[3];	/* Sorted, unused ranges are zeroed */
+};
+
+/*
+ * Bit fields
+ */
+
+struct dmi_bitfield
+{
+	u8 first;		/* Bit number of names[0] */
+	u8 count;
+	const char * const *names;	/* NULL for reserved bits */
+};
+
+/*
+ * Field descriptors
+ */
+
+enum dmi_field_format
+{
+	FIELD_STRING,		/* String number */
+	FIELD_ENUM,		/* Byte value, looked up in values */
+	FIELD_NUMBER,		/* Unsigned integer of the given width */
+	FIELD_CUSTOM,		/* Dedicated decoding function */
+};
+
+struct dmi_field
+{
+	u8 type;
+	u8 offset;
+	u8 width;		/* In bytes */
+	u8 length;		/* Minimum structure length */
+	enum dmi_field_format format;
+	const char *name;	/* Attribute name, as displayed when decoding */
+	const struct dmi_enum *values;
+	void (*decode)(const struct dmi_field *f, const struct dmi_header *h,
+		       u16 ver);
+};
+
+extern const struct dmi_field dmi_fields[];
+extern const unsigned int dmi_field_count;
+
+/*
+ * Structure index
+ */
+
+struct dmi_index_entry
+{
+	struct dmi_header h;
+	u32 size;		/* Including strings and terminator */
+};
+
+struct dmi_index
+{
+	struct dmi_index_entry *entry;	/* In table order */
+	unsigned int count;
+	struct dmi_index_entry **by_handle;
+};
+
 int is_printable(const u8 *data, int len);
 const char *dmi_string(const struct dmi_header *dm, u8 s);
+const char *dmi_smbios_structure_type(u8 code);
 void dmi_print_memory_size(const char *addr, u64 code, int shift);
+unsigned long long dmi_cache_size_2_kb(u32 code);
+const char *dmi_event_log_descriptor_type(u8 code);
+const char *dmi_protocol_assignment_type(u8 type);
+const char *dmi_address_type(u8 type);
+const char *dmi_address_decode(const u8 *data, char *storage, u8 addrtype);
+const char *dmi_parse_device_type(u8 type);
+const char *dmi_ipmi_interface_type(u8 code);
+const char *dmi_ipmi_base_address_value(u8 type, const u8 *p, u8 lsb,
+					char *buf, size_t size);
+const char *dmi_ipmi_register_spacing(u8 code);
 void dmi_print_cpuid(void (*print_cb)(const char *name, const char *format, ...),
 		     const char *label, enum cpuid_type sig, const u8 *p);
+const char *dmi_enum_name(const struct dmi_enum *e, u8 code);
+int dmi_enum_code(const struct dmi_enum *e, const char *name);
+int dmi_bitfield_next(const struct dmi_bitfield *b, u32 *code);
+void dmi_bitfield_list(const struct dmi_bitfield *b, u32 code);
+int dmi_bitfield_join(const struct dmi_bitfield *b, u32 code,
+		      char *buf, size_t size);
+unsigned int dmi_processor_count(const struct dmi_header *h, u8 offset);
+unsigned long long dmi_memory_device_size_kb(const struct dmi_header *h);
+const struct dmi_field *dmi_field_find(u8 type, const char *name);
+const struct dmi_field *dmi_field_at(u8 type, u8 offset);
+const char *dmi_field_value(const struct dmi_field *f,
+			    const struct dmi_header *h, u16 ver,
+			    char *buf, size_t size);
+int dmi_index_build(struct dmi_index *idx, u8 *buf, u32 len, u16 num,
+		    int stop_at_eot);
+void dmi_index_free(struct dmi_index *idx);
+const struct dmi_index_entry *dmi_index_find(const struct dmi_index *idx,
+					     u16 handle);
 
 #endif
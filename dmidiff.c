@@ -0,0 +1,460 @@
+/*
+ * Structural comparison and fingerprinting of DMI tables
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "util.h"
+#include "dmidecode.h"
+#include "dmiopt.h"
+#include "dmioutput.h"
+#include "dmidiff.h"
+
+/*
+ * Structures are paired by type and by the strings which identify them
+ * (typically their location), so that they still match if their handle or
+ * position in the table changed. Types which appear only once are paired
+ * by type alone. Other types are paired by handle.
+ */
+static const struct
+{
+	u8 type;
+	u8 offset[2];		/* Offsets of key strings, 0 if unused */
+} dmi_diff_keys[] = {
+	{ 0, { 0, 0 } },
+	{ 1, { 0, 0 } },
+	{ 4, { 0x04, 0 } },	/* Socket Designation */
+	{ 7, { 0x04, 0 } },	/* Socket Designation */
+	{ 8, { 0x04, 0x06 } },	/* Reference Designators */
+	{ 9, { 0x04, 0 } },	/* Designation */
+	{ 17, { 0x10, 0x11 } },	/* Locator, Bank Locator */
+	{ 26, { 0x04, 0 } },	/* Description */
+	{ 27, { 0x0E, 0 } },	/* Description */
+	{ 28, { 0x04, 0 } },	/* Description */
+	{ 29, { 0x04, 0 } },	/* Description */
+	{ 32, { 0, 0 } },
+	{ 39, { 0x05, 0x06 } },	/* Location, Device Name */
+	{ 41, { 0x04, 0 } },	/* Reference Designation */
+	{ 127, { 0, 0 } },
+};
+
+struct dmi_diff_table
+{
+	const struct dmi_index *idx;
+	u16 ver;
+	unsigned long long *hash;	/* Contents hash of each structure */
+	int *match;		/* Paired structure in the other table, or -1 */
+};
+
+struct dmi_diff_item
+{
+	unsigned long long key;
+	unsigned int n;		/* Structure number in its table */
+};
+
+static int dmi_diff_key_index(u8 type)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(dmi_diff_keys); i++)
+		if (dmi_diff_keys[i].type == type)
+			return i;
+	return -1;
+}
+
+/* Everything but the handle, which may change without anything else */
+static unsigned long long dmi_diff_hash(const struct dmi_index_entry *e)
+{
+	unsigned long long h;
+
+	h = hash64(e->h.data, 2, HASH64_INIT);
+	return hash64(e->h.data + 4, e->size - 4, h);
+}
+
+static unsigned long long dmi_diff_key(const struct dmi_index_entry *e)
+{
+	const struct dmi_header *h = &e->h;
+	unsigned long long key;
+	int k, i;
+
+	key = hash64(&h->type, 1, HASH64_INIT);
+	k = dmi_diff_key_index(h->type);
+	if (k < 0)
+		return hash64(h->data + 2, 2, key);
+
+	for (i = 0; i < 2 && dmi_diff_keys[k].offset[i]; i++)
+	{
+		u8 off = dmi_diff_keys[k].offset[i];
+		const char *s = off < h->length ? dmi_string(h, h->data[off]) : "";
+
+		key = hash64(s, strlen(s) + 1, key);
+	}
+	return key;
+}
+
+static int dmi_diff_item_cmp(const void *a, const void *b)
+{
+	const struct dmi_diff_item *ia = a, *ib = b;
+
+	if (ia->key != ib->key)
+		return ia->key < ib->key ? -1 : 1;
+	return ia->n < ib->n ? -1 : ia->n > ib->n;
+}
+
+static int dmi_diff_selected(const struct dmi_index_entry *e)
+{
+	return opt.type == NULL || opt.type[e->h.type];
+}
+
+/* Hash and sort the selected structures of a table by key */
+static struct dmi_diff_item *dmi_diff_items(struct dmi_diff_table *t,
+					    unsigned int *count)
+{
+	struct dmi_diff_item *item;
+	unsigned int i;
+
+	item = malloc((t->idx->count ? t->idx->count : 1) * sizeof(*item));
+	if (item == NULL)
+		return NULL;
+
+	*count = 0;
+	for (i = 0; i < t->idx->count; i++)
+	{
+		const struct dmi_index_entry *e = &t->idx->entry[i];
+
+		t->match[i] = -1;
+		if (!dmi_diff_selected(e))
+			continue;
+		t->hash[i] = dmi_diff_hash(e);
+		item[*count].key = dmi_diff_key(e);
+		item[*count].n = i;
+		(*count)++;
+	}
+	qsort(item, *count, sizeof(*item), dmi_diff_item_cmp);
+
+	return item;
+}
+
+/* Returns string number n of a structure, or NULL if there is none */
+static const char *dmi_diff_string(const struct dmi_index_entry *e, u8 n)
+{
+	const char *s = (const char *)e->h.data + e->h.length;
+	const char *end = (const char *)e->h.data + e->size - 1;
+
+	if (n == 0)
+		return NULL;
+	while (--n && s < end)
+		s += strlen(s) + 1;
+	return s < end && *s ? s : NULL;
+}
+
+static void dmi_diff_heading(const char *what, const struct dmi_index_entry *e,
+			     const struct dmi_index_entry *was)
+{
+	const struct dmi_header *h = &e->h;
+	char label[128] = "";
+	int k, i;
+
+	k = dmi_diff_key_index(h->type);
+	for (i = 0; k >= 0 && i < 2 && dmi_diff_keys[k].offset[i]; i++)
+	{
+		u8 off = dmi_diff_keys[k].offset[i];
+		size_t l = strlen(label);
+
+		if (off < h->length)
+			snprintf(label + l, sizeof(label) - l, "%s%s",
+				 i ? ", " : " (", dmi_string(h, h->data[off]));
+	}
+	if (label[0])
+		strncat(label, ")", sizeof(label) - strlen(label) - 1);
+
+	if (was != NULL && was->h.handle != h->handle)
+		pr_info("%s: Handle 0x%04X (was 0x%04X), DMI type %u, %s%s",
+			what, h->handle, was->h.handle, h->type,
+			dmi_smbios_structure_type(h->type), label);
+	else
+		pr_info("%s: Handle 0x%04X, DMI type %u, %s%s", what,
+			h->handle, h->type, dmi_smbios_structure_type(h->type),
+			label);
+}
+
+/*
+ * Print what changed between two structures: the value of the fields we
+ * know about, then the raw bytes which aren't covered by a known field,
+ * then the strings which weren't already reported.
+ */
+static void dmi_diff_fields(const struct dmi_index_entry *a, u16 ver_a,
+			    const struct dmi_index_entry *b, u16 ver_b)
+{
+	u8 covered[256], reported[256];
+	unsigned int i, off, min_len, count_a, count_b;
+
+	memset(covered, 0, sizeof(covered));
+	memset(reported, 0, sizeof(reported));
+
+	for (i = 0; i < dmi_field_count; i++)
+	{
+		const struct dmi_field *f = &dmi_fields[i];
+		char buf_a[80], buf_b[80];
+		const char *va, *vb;
+
+		if (f->type != a->h.type)
+			continue;
+
+		memset(covered + f->offset, 1, f->width);
+		if (f->format == FIELD_STRING)
+		{
+			if (f->offset < a->h.length)
+				reported[a->h.data[f->offset]] = 1;
+			if (f->offset < b->h.length)
+				reported[b->h.data[f->offset]] = 1;
+		}
+
+		va = dmi_field_value(f, &a->h, ver_a, buf_a, sizeof(buf_a));
+		vb = dmi_field_value(f, &b->h, ver_b, buf_b, sizeof(buf_b));
+		if (va == vb || (va && vb && strcmp(va, vb) == 0))
+			continue;
+		pr_attr(f->name, "%s -> %s", va ? va : "(none)",
+			vb ? vb : "(none)");
+	}
+
+	if (a->h.length != b->h.length)
+		pr_attr("Length", "0x%02X -> 0x%02X", a->h.length, b->h.length);
+
+	/* Runs of differing bytes, at most 8 per line */
+	min_len = a->h.length < b->h.length ? a->h.length : b->h.length;
+	off = 4;
+	while (off < min_len)
+	{
+		char name[16], hex_a[8 * 3 + 1], hex_b[8 * 3 + 1];
+		unsigned int start = off;
+
+		if (covered[off] || a->h.data[off] == b->h.data[off])
+		{
+			off++;
+			continue;
+		}
+
+		while (off < min_len && off - start < 8 && !covered[off]
+		    && a->h.data[off] != b->h.data[off])
+		{
+			sprintf(hex_a + 3 * (off - start), "%02X ", a->h.data[off]);
+			sprintf(hex_b + 3 * (off - start), "%02X ", b->h.data[off]);
+			off++;
+		}
+		/* Drop the trailing space */
+		hex_a[3 * (off - start) - 1] = '\0';
+		hex_b[3 * (off - start) - 1] = '\0';
+		sprintf(name, "Offset 0x%02X", start);
+		pr_attr(name, "%s -> %s", hex_a, hex_b);
+	}
+
+	/* Strings which are not attached to a known field */
+	count_a = count_b = 0;
+	while (count_a < 255 && dmi_diff_string(a, count_a + 1) != NULL)
+		count_a++;
+	while (count_b < 255 && dmi_diff_string(b, count_b + 1) != NULL)
+		count_b++;
+	for (i = 1; i <= count_a || i <= count_b; i++)
+	{
+		const char *sa = dmi_diff_string(a, i);
+		const char *sb = dmi_diff_string(b, i);
+
+		if (reported[i] || (sa && sb && strcmp(sa, sb) == 0))
+			continue;
+		pr_attr("String", "%u: %s -> %s", i, sa ? sa : "(none)",
+			sb ? sb : "(none)");
+	}
+}
+
+/*
+ * Compare two tables and print the structures which were removed, added
+ * or changed, from table a (reference) to table b (current).
+ */
+void dmi_diff(const struct dmi_index *idx_a, u16 ver_a,
+	      const struct dmi_index *idx_b, u16 ver_b)
+{
+	struct dmi_diff_table a = { idx_a, ver_a, NULL, NULL };
+	struct dmi_diff_table b = { idx_b, ver_b, NULL, NULL };
+	struct dmi_diff_item *item_a = NULL, *item_b = NULL;
+	unsigned int count_a, count_b, i, j, changes = 0;
+
+	a.hash = malloc((idx_a->count + 1) * sizeof(*a.hash));
+	a.match = malloc((idx_a->count + 1) * sizeof(*a.match));
+	b.hash = malloc((idx_b->count + 1) * sizeof(*b.hash));
+	b.match = malloc((idx_b->count + 1) * sizeof(*b.match));
+	if (a.hash == NULL || a.match == NULL || b.hash == NULL
+	 || b.match == NULL
+	 || (item_a = dmi_diff_items(&a, &count_a)) == NULL
+	 || (item_b = dmi_diff_items(&b, &count_b)) == NULL)
+	{
+		perror("malloc");
+		goto out;
+	}
+
+	/* Pair structures with the same key, in table order */
+	i = j = 0;
+	while (i < count_a && j < count_b)
+	{
+		if (item_a[i].key < item_b[j].key)
+			i++;
+		else if (item_a[i].key > item_b[j].key)
+			j++;
+		else
+		{
+			a.match[item_a[i].n] = item_b[j].n;
+			b.match[item_b[j].n] = item_a[i].n;
+			i++;
+			j++;
+		}
+	}
+
+	for (i = 0; i < idx_a->count; i++)
+	{
+		if (!dmi_diff_selected(&idx_a->entry[i]) || a.match[i] >= 0)
+			continue;
+		dmi_diff_heading("Removed", &idx_a->entry[i], NULL);
+		pr_sep();
+		changes++;
+	}
+
+	for (i = 0; i < idx_b->count; i++)
+	{
+		const struct dmi_index_entry *e = &idx_b->entry[i];
+		int m = b.match[i];
+
+		if (!dmi_diff_selected(e))
+			continue;
+		if (m < 0)
+		{
+			dmi_diff_heading("Added", e, NULL);
+			pr_sep();
+			changes++;
+			continue;
+		}
+		if (a.hash[m] == b.hash[i])
+			continue;
+
+		dmi_diff_heading("Changed", e, &idx_a->entry[m]);
+		dmi_diff_fields(&idx_a->entry[m], ver_a, e, ver_b);
+		pr_sep();
+		changes++;
+	}
+
+	if (!(opt.flags & FLAG_QUIET))
+		pr_comment("%u difference%s found.", changes,
+			   changes == 1 ? "" : "s");
+
+out:
+	free(item_a);
+	free(item_b);
+	free(a.hash);
+	free(a.match);
+	free(b.hash);
+	free(b.match);
+}
+
+/*
+ * Contents hash of a structure, without the handle (reported separately)
+ * and without the fields which change at run time.
+ */
+static unsigned long long dmi_fingerprint_hash(const struct dmi_index_entry *e)
+{
+	const struct dmi_header *h = &e->h;
+	u8 data[256];
+	unsigned int i;
+
+	memcpy(data, h->data, h->length);
+	data[2] = data[3] = 0;
+
+	switch (h->type)
+	{
+		case 15: /* Log Status and Log Change Token */
+			for (i = 0x0B; i < 0x10 && i < h->length; i++)
+				data[i] = 0;
+			break;
+		case 26: /* Status */
+		case 28:
+		case 29:
+			if (h->length > 0x05)
+				data[0x05] &= 0x1F;
+			break;
+		case 27: /* Status */
+			if (h->length > 0x06)
+				data[0x06] &= 0x1F;
+			break;
+		case 32: /* Boot Status */
+			for (i = 0x0A; i < h->length; i++)
+				data[i] = 0;
+			break;
+	}
+
+	return hash64(h->data + h->length, e->size - h->length,
+		      hash64(data, h->length, HASH64_INIT));
+}
+
+/*
+ * Print a hash of each (selected) structure, and a hash of the whole
+ * table which also covers the types and handles.
+ */
+void dmi_fingerprint(const struct dmi_index *idx)
+{
+	unsigned long long *hash, table = HASH64_INIT;
+	unsigned int i;
+
+	hash = malloc((idx->count + 1) * sizeof(*hash));
+	if (hash == NULL)
+	{
+		perror("malloc");
+		return;
+	}
+
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_index_entry *e = &idx->entry[i];
+		u8 key[11];
+		int j;
+
+		if (!dmi_diff_selected(e))
+			continue;
+
+		/* Byte order must not depend on the host */
+		hash[i] = dmi_fingerprint_hash(e);
+		key[0] = e->h.type;
+		key[1] = e->h.data[2];
+		key[2] = e->h.data[3];
+		for (j = 0; j < 8; j++)
+			key[3 + j] = hash[i] >> (8 * j);
+		table = hash64(key, sizeof(key), table);
+	}
+
+	pr_info("Table %016llX", table);
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_index_entry *e = &idx->entry[i];
+
+		if (dmi_diff_selected(e))
+			pr_info("%u 0x%04X %016llX", e->h.type, e->h.handle,
+				hash[i]);
+	}
+
+	free(hash);
+}
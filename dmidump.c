@@ -0,0 +1,355 @@
+/*
+ * Indexed binary dump files
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * With --dump-index, the index below is appended to the binary dump file,
+ * after the table. Readers which don't know about it only look at the
+ * entry point and the table, so they are not affected. All offsets are
+ * from the start of the file, and all values are little-endian.
+ *
+ * Index header (0x20 bytes):
+ *   0x00  DWORD  Table length
+ *   0x04  DWORD  Number of structures
+ *   0x08  DWORD  Offset of the structure entries
+ *   0x0C  DWORD  Offset of the handle order
+ *   0x10  DWORD  Number of strings
+ *   0x14  DWORD  Offset of the string offsets
+ *   0x18  DWORD  Offset of the metadata
+ *   0x1C  DWORD  Length of the metadata
+ *
+ * Structure entries (0x10 bytes each, in table order):
+ *   0x00  DWORD  Offset of the structure
+ *   0x04  BYTE   Type
+ *   0x05  BYTE   Length (of the formatted area)
+ *   0x06  WORD   Handle
+ *   0x08  DWORD  Size (formatted area and strings)
+ *   0x0C  DWORD  Index of the first string in the string offsets; the
+ *                strings of a structure run up to the first string of
+ *                the next one
+ *
+ * Handle order: one DWORD per structure, the structure entry numbers
+ * sorted by handle, for binary search.
+ *
+ * String offsets: one DWORD per string, the offset of the string.
+ *
+ * Metadata: "key=value" strings, each terminated by a NUL byte.
+ *
+ * Trailer (0x10 bytes, at the very end of the file):
+ *   0x00  8 bytes  Signature "_DMIIDX_"
+ *   0x08  DWORD    Offset of the index header
+ *   0x0C  DWORD    Format version (1)
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "version.h"
+#include "types.h"
+#include "util.h"
+#include "dmiopt.h"
+#include "dmioutput.h"
+#include "dmidump.h"
+
+#define INDEX_SIGNATURE		"_DMIIDX_"
+#define INDEX_VERSION		1
+#define INDEX_HEADER_LEN	0x20
+#define INDEX_ENTRY_LEN		0x10
+#define INDEX_TRAILER_LEN	0x10
+
+struct dmi_dump_entry
+{
+	u32 offset;
+	u8 type;
+	u8 length;
+	u16 handle;
+	u32 size;
+	u32 first_string;
+};
+
+/* Used to sort the handle order, not reentrant but we don't need it to be */
+static const struct dmi_dump_entry *sort_entry;
+
+static int dmi_dump_cmp_handle(const void *a, const void *b)
+{
+	const struct dmi_dump_entry *ea = &sort_entry[*(const u32 *)a];
+	const struct dmi_dump_entry *eb = &sort_entry[*(const u32 *)b];
+
+	if (ea->handle != eb->handle)
+		return ea->handle < eb->handle ? -1 : 1;
+	return *(const u32 *)a < *(const u32 *)b ? -1 : 1;
+}
+
+static void put_dword(u8 *p, u32 v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+}
+
+static int dmi_dump_fwrite(const void *data, size_t len, FILE *f,
+			   const char *filename)
+{
+	if (len && fwrite(data, len, 1, f) != 1)
+	{
+		fprintf(stderr, "%s: ", filename);
+		perror("fwrite");
+		return -1;
+	}
+	return 0;
+}
+
+/* Append a metadata string, entries which don't fit are left out */
+static size_t dmi_dump_metadata_add(char *buf, size_t size, size_t len,
+				    const char *format, ...)
+{
+	va_list args;
+	int n;
+
+	va_start(args, format);
+	n = vsnprintf(buf + len, size - len, format, args);
+	va_end(args);
+
+	if (n < 0 || (size_t)n >= size - len)
+		return len;
+	return len + n + 1;
+}
+
+static size_t dmi_dump_metadata(char *buf, size_t size, const char *source)
+{
+	struct utsname uts;
+	time_t now = time(NULL);
+	struct tm *tm = gmtime(&now);
+	char date[32];
+	size_t len = 0;
+
+	len = dmi_dump_metadata_add(buf, size, len, "source=%s", source);
+	if (tm != NULL
+	 && strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", tm) != 0)
+		len = dmi_dump_metadata_add(buf, size, len, "time=%s", date);
+	if (uname(&uts) == 0)
+		len = dmi_dump_metadata_add(buf, size, len, "kernel=%s %s %s",
+					    uts.sysname, uts.release,
+					    uts.machine);
+	len = dmi_dump_metadata_add(buf, size, len, "dmidecode=%s", VERSION);
+
+	return len;
+}
+
+/*
+ * Append the index to a dump file, the table was written at table_offset.
+ */
+int dmi_dump_index_write(FILE *f, const char *filename, u32 table_offset,
+			 const u8 *table, u32 table_len, const char *source)
+{
+	struct dmi_dump_entry *entry = NULL;
+	u32 *order = NULL, *string = NULL;
+	u32 count = 0, strings = 0, alloc = 0, str_alloc = 0;
+	u32 offset = 0, pos, i;
+	u8 header[INDEX_HEADER_LEN], trailer[INDEX_TRAILER_LEN];
+	u8 *out = NULL;
+	char metadata[512];
+	size_t metadata_len;
+	int ret = -1;
+
+	/* Walk the table, stop at the first invalid structure */
+	while (offset + 4 <= table_len && table[offset + 1] >= 4
+	    && table[offset + 1] <= table_len - offset)
+	{
+		const u8 *p = table + offset;
+		u32 end = p[1];
+
+		/* Find the end of the string area */
+		while (end + 1 < table_len - offset && (p[end] || p[end + 1]))
+			end++;
+		if (end + 1 >= table_len - offset)
+			break;
+
+		if (count == alloc)
+		{
+			struct dmi_dump_entry *e;
+
+			alloc = alloc ? alloc * 2 : 64;
+			if ((e = realloc(entry, alloc * sizeof(*e))) == NULL)
+			{
+				perror("realloc");
+				goto out;
+			}
+			entry = e;
+		}
+		entry[count].offset = table_offset + offset;
+		entry[count].type = p[0];
+		entry[count].length = p[1];
+		entry[count].handle = WORD(p + 2);
+		entry[count].size = end + 2;
+		entry[count].first_string = strings;
+
+		/* Record where each string starts */
+		for (i = p[1]; i < end; i += strlen((const char *)p + i) + 1)
+		{
+			if (strings == str_alloc)
+			{
+				u32 *s;
+
+				str_alloc = str_alloc ? str_alloc * 2 : 256;
+				if ((s = realloc(string, str_alloc * sizeof(*s))) == NULL)
+				{
+					perror("realloc");
+					goto out;
+				}
+				string = s;
+			}
+			put_dword((u8 *)&string[strings++],
+				  table_offset + offset + i);
+		}
+
+		offset += end + 2;
+		count++;
+	}
+
+	if ((order = malloc((count + 1) * sizeof(*order))) == NULL
+	 || (out = malloc((size_t)count * INDEX_ENTRY_LEN + 1)) == NULL)
+	{
+		perror("malloc");
+		goto out;
+	}
+	for (i = 0; i < count; i++)
+		order[i] = i;
+	sort_entry = entry;
+	qsort(order, count, sizeof(*order), dmi_dump_cmp_handle);
+	for (i = 0; i < count; i++)
+		put_dword((u8 *)&order[i], order[i]);
+
+	for (i = 0; i < count; i++)
+	{
+		u8 *p = out + i * INDEX_ENTRY_LEN;
+
+		put_dword(p, entry[i].offset);
+		p[0x04] = entry[i].type;
+		p[0x05] = entry[i].length;
+		p[0x06] = entry[i].handle;
+		p[0x07] = entry[i].handle >> 8;
+		put_dword(p + 0x08, entry[i].size);
+		put_dword(p + 0x0C, entry[i].first_string);
+	}
+
+	metadata_len = dmi_dump_metadata(metadata, sizeof(metadata), source);
+
+	/* The index follows the table, aligned to 8 bytes */
+	pos = (table_offset + table_len + 7) & ~7U;
+	put_dword(header + 0x00, table_len);
+	put_dword(header + 0x04, count);
+	put_dword(header + 0x08, pos + INDEX_HEADER_LEN);
+	put_dword(header + 0x0C, pos + INDEX_HEADER_LEN + count * INDEX_ENTRY_LEN);
+	put_dword(header + 0x10, strings);
+	put_dword(header + 0x14, pos + INDEX_HEADER_LEN + count * (INDEX_ENTRY_LEN + 4));
+	put_dword(header + 0x18, DWORD(header + 0x14) + strings * 4);
+	put_dword(header + 0x1C, metadata_len);
+
+	memcpy(trailer, INDEX_SIGNATURE, 8);
+	put_dword(trailer + 0x08, pos);
+	put_dword(trailer + 0x0C, INDEX_VERSION);
+
+	if (!(opt.flags & FLAG_QUIET))
+		pr_comment("Writing index of %u structures to %s.", count,
+			   filename);
+	if (fseek(f, pos, SEEK_SET) != 0)
+	{
+		fprintf(stderr, "%s: ", filename);
+		perror("fseek");
+		goto out;
+	}
+	if (dmi_dump_fwrite(header, sizeof(header), f, filename)
+	 || dmi_dump_fwrite(out, (size_t)count * INDEX_ENTRY_LEN, f, filename)
+	 || dmi_dump_fwrite(order, (size_t)count * 4, f, filename)
+	 || dmi_dump_fwrite(string, (size_t)strings * 4, f, filename)
+	 || dmi_dump_fwrite(metadata, metadata_len, f, filename))
+		goto out;
+
+	/* Align the trailer to 8 bytes as well */
+	pos = DWORD(header + 0x18) + metadata_len;
+	if (fseek(f, ((pos + 7) & ~7U) - pos, SEEK_CUR) != 0)
+	{
+		fprintf(stderr, "%s: ", filename);
+		perror("fseek");
+		goto out;
+	}
+	ret = dmi_dump_fwrite(trailer, sizeof(trailer), f, filename);
+
+out:
+	free(out);
+	free(order);
+	free(string);
+	free(entry);
+	return ret;
+}
+
+/*
+ * If the dump file has an index, print the capture metadata.
+ */
+void dmi_dump_index_print(const char *filename)
+{
+	struct stat st;
+	size_t size;
+	u8 *trailer, *header = NULL, *metadata = NULL;
+	u32 pos;
+
+	if (stat(filename, &st) != 0 || st.st_size < 0x20 + INDEX_HEADER_LEN
+						    + INDEX_TRAILER_LEN)
+		return;
+
+	size = INDEX_TRAILER_LEN;
+	trailer = read_file(st.st_size - INDEX_TRAILER_LEN, &size, filename);
+	if (trailer == NULL || size != INDEX_TRAILER_LEN
+	 || memcmp(trailer, INDEX_SIGNATURE, 8) != 0
+	 || DWORD(trailer + 0x0C) != INDEX_VERSION)
+		goto out;
+
+	pos = DWORD(trailer + 0x08);
+	size = INDEX_HEADER_LEN;
+	if (pos > st.st_size - INDEX_HEADER_LEN
+	 || (header = read_file(pos, &size, filename)) == NULL
+	 || size != INDEX_HEADER_LEN)
+		goto out;
+
+	if (DWORD(header + 0x1C) != 0)
+	{
+		const char *p;
+
+		size = DWORD(header + 0x1C);
+		metadata = read_file(DWORD(header + 0x18), &size, filename);
+		if (metadata == NULL || size == 0)
+			goto out;
+		/* Make sure the last string is terminated */
+		metadata[size - 1] = '\0';
+		for (p = (const char *)metadata; p < (const char *)metadata + size;
+		     p += strlen(p) + 1)
+			if (*p)
+				pr_comment("Dump %s", p);
+	}
+
+out:
+	free(metadata);
+	free(header);
+	free(trailer);
+}
@@ -0,0 +1,200 @@
+/*
+ * System event log reader
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * The System Event Log structure (type 15) describes where the log area
+ * is, but not what it contains. Only memory-mapped log areas (access
+ * method 0x03) can be read. The log area is read in chunks of a fixed
+ * size, and each record is displayed as soon as it was read, so memory
+ * use doesn't depend on the size of the log.
+ *
+ * Record offsets are relative to the start of the log data. The offset
+ * following the last record is displayed at the end, so that the next
+ * run can start from there and only read the records added meanwhile.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "types.h"
+#include "util.h"
+#include "dmidecode.h"
+#include "dmiopt.h"
+#include "dmioutput.h"
+#include "dmievent.h"
+
+#define EVENT_LOG_CHUNK		4096
+
+/* 7.16.6.2 Variable data format of a log type, from the descriptors */
+static u8 dmi_event_log_data_format(const struct dmi_header *h, u8 type)
+{
+	u8 count, len;
+	const u8 *p = h->data + 0x17;
+	int i;
+
+	if (h->length < 0x17)
+		return 0x00;
+	count = h->data[0x15];
+	len = h->data[0x16];
+	if (len < 0x02 || h->length < 0x17 + count * len)
+		return 0x00;
+	for (i = 0; i < count; i++, p += len)
+		if (p[0] == type)
+			return p[1];
+	return 0x00;
+}
+
+/* 7.16.6.2 */
+static void dmi_event_log_data(u8 format, const u8 *p, u8 len)
+{
+	switch (format)
+	{
+		case 0x01:
+			if (len >= 2)
+				printf("Handle 0x%04X", WORD(p));
+			break;
+		case 0x02:
+			if (len >= 4)
+				printf("Count %u", DWORD(p));
+			break;
+		case 0x03:
+			if (len >= 6)
+				printf("Handle 0x%04X, Count %u", WORD(p),
+				       DWORD(p + 2));
+			break;
+		case 0x04:
+			if (len >= 8)
+				printf("Bitmap 0x%08X 0x%08X", DWORD(p),
+				       DWORD(p + 4));
+			break;
+		case 0x05:
+			if (len >= 4)
+				printf("Type 0x%08X", DWORD(p));
+			break;
+		case 0x06:
+			if (len >= 8)
+				printf("Type 0x%08X, Count %u", DWORD(p),
+				       DWORD(p + 4));
+			break;
+	}
+}
+
+/*
+ * 7.16.6 Log record format: type, length (the most significant bit tells
+ * if the record was read), date and time in BCD, then the variable data.
+ */
+static void dmi_event_log_record(const struct dmi_header *h, u16 offset,
+				 const u8 *p)
+{
+	u8 len = p[1] & 0x7F;
+
+	printf("0x%04X\t%s%02X-%02X-%02X %02X:%02X:%02X\t%s\t", offset,
+	       p[2] >= 0x80 ? "19" : "20", p[2], p[3], p[4], p[5], p[6], p[7],
+	       dmi_event_log_descriptor_type(p[0]));
+	dmi_event_log_data(dmi_event_log_data_format(h, p[0]), p + 8, len - 8);
+	printf("\n");
+}
+
+static void dmi_event_log_read(const struct dmi_header *h)
+{
+	const u8 *data = h->data;
+	u32 base = DWORD(data + 0x10) + WORD(data + 0x08);
+	u32 end, pos = opt.event_log_offset;
+	u8 *chunk;
+
+	if (WORD(data + 0x08) > WORD(data + 0x04))
+	{
+		fprintf(stderr, "Handle 0x%04X: Invalid log area\n", h->handle);
+		return;
+	}
+	end = WORD(data + 0x04) - WORD(data + 0x08);
+	if (pos > end)
+	{
+		fprintf(stderr, "Handle 0x%04X: Offset 0x%04X beyond end of log data\n",
+			h->handle, pos);
+		return;
+	}
+
+	while (pos + 8 <= end)
+	{
+		u32 size = end - pos < EVENT_LOG_CHUNK ? end - pos : EVENT_LOG_CHUNK;
+		u32 i = 0;
+		int done = 0;
+		u8 len;
+
+		if ((chunk = mem_chunk(base + pos, size, opt.devmem)) == NULL)
+			break;
+
+		while (i + 8 <= size)
+		{
+			len = chunk[i + 1] & 0x7F;
+			if (chunk[i] == 0xFF || len < 8)
+			{
+				done = 1;
+				break;
+			}
+			/* Records which cross the end of the chunk are read again */
+			if (i + len > size)
+				break;
+			dmi_event_log_record(h, pos + i, chunk + i);
+			i += len;
+		}
+		fflush(stdout);
+		free(chunk);
+
+		if (pos + size >= end)
+			done = 1;
+		pos += i;
+		if (done)
+			break;
+	}
+
+	pr_comment("Next offset 0x%04X.", pos);
+}
+
+void dmi_event_log(const struct dmi_index *idx)
+{
+	unsigned int i, found = 0;
+
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+
+		if (h->type != 15 || h->length < 0x14)
+			continue;
+		found++;
+
+		pr_comment("System Event Log 0x%04X, change token 0x%08X.",
+			   h->handle, DWORD(h->data + 0x0C));
+		if (h->data[0x0A] != 0x03)
+		{
+			fprintf(stderr, "Handle 0x%04X: Access method 0x%02X not supported\n",
+				h->handle, h->data[0x0A]);
+			continue;
+		}
+		if (!(h->data[0x0B] & 0x01))
+		{
+			fprintf(stderr, "Handle 0x%04X: Log area not valid\n",
+				h->handle);
+			continue;
+		}
+		dmi_event_log_read(h);
+	}
+
+	if (!found)
+		fprintf(stderr, "No system event log found\n");
+}
@@ -0,0 +1,300 @@
+/*
+ * Machine-readable exports of DMI tables
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * The CSV export has one row per structure and one column per field of
+ * the field descriptor table, so column names are the attribute names
+ * displayed when decoding. Cells are quoted as described in RFC 4180.
+ *
+ * The shell export has one NAME='value' line per string keyword of
+ * --string, named after the keyword, followed by the OEM strings and a few
+ * values derived from the processor and memory device entries. The output
+ * is meant to be evaluated by a shell, so values are single-quoted.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "types.h"
+#include "dmidecode.h"
+#include "dmiopt.h"
+#include "dmioutput.h"
+#include "dmiexport.h"
+
+int dmi_csv_has_fields(u8 type)
+{
+	unsigned int i;
+
+	for (i = 0; i < dmi_field_count; i++)
+		if (dmi_fields[i].type == type)
+			return 1;
+
+	return 0;
+}
+
+/* A missing value gives an empty cell */
+static void dmi_csv_cell(const char *s)
+{
+	if (s == NULL)
+		return;
+
+	if (strpbrk(s, ",\"\r\n") == NULL)
+	{
+		fputs(s, stdout);
+		return;
+	}
+
+	putchar('"');
+	for (; *s; s++)
+	{
+		if (*s == '"')
+			putchar('"');
+		putchar(*s);
+	}
+	putchar('"');
+}
+
+void dmi_csv_header(u8 type)
+{
+	unsigned int i;
+
+	fputs("Source,Handle", stdout);
+	for (i = 0; i < dmi_field_count; i++)
+	{
+		if (dmi_fields[i].type != type)
+			continue;
+		putchar(',');
+		dmi_csv_cell(dmi_fields[i].name);
+	}
+	putchar('\n');
+}
+
+void dmi_csv_row(const char *source, const struct dmi_header *h, u16 ver)
+{
+	char buf[256];
+	unsigned int i;
+
+	dmi_csv_cell(source);
+	printf(",0x%04X", h->handle);
+	for (i = 0; i < dmi_field_count; i++)
+	{
+		if (dmi_fields[i].type != h->type)
+			continue;
+		putchar(',');
+		dmi_csv_cell(dmi_field_value(&dmi_fields[i], h, ver,
+					     buf, sizeof(buf)));
+	}
+	putchar('\n');
+}
+
+/*
+ * Value of a string keyword, taken from h if it has the right type, else
+ * from the first entry of that type like --string. Returns NULL if there
+ * is no such entry or value.
+ */
+const char *dmi_keyword_value(const struct dmi_index *idx,
+			      const struct dmi_header *h,
+			      const struct string_keyword *key, u16 ver,
+			      char *buf, size_t size)
+{
+	const struct dmi_field *f = dmi_field_at(key->type, key->offset);
+	unsigned int i;
+
+	if (f == NULL)
+		return NULL;
+
+	for (i = 0; (h == NULL || h->type != key->type) && i < idx->count; i++)
+		if (idx->entry[i].h.type == key->type)
+			h = &idx->entry[i].h;
+	if (h == NULL || h->type != key->type)
+		return NULL;
+
+	return dmi_field_value(f, h, ver, buf, size);
+}
+
+/* OEM strings are numbered from 1 across all OEM Strings entries */
+const char *dmi_oem_string(const struct dmi_index *idx, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+
+		if (h->type != 11 || h->length < 5)
+			continue;
+		if (n <= h->data[4])
+			return dmi_string(h, n);
+		n -= h->data[4];
+	}
+
+	return NULL;
+}
+
+/* The variable name is the keyword in upper case, with - replaced by _ */
+static void dmi_export_name(const char *keyword)
+{
+	for (; *keyword; keyword++)
+		putchar(*keyword == '-' ? '_' : toupper((unsigned char)*keyword));
+}
+
+/* Single quotes are closed, escaped and reopened: ' becomes '\'' */
+static void dmi_export_value(const char *s)
+{
+	putchar('\'');
+	for (; s != NULL && *s; s++)
+	{
+		if (*s == '\'')
+			fputs("'\\''", stdout);
+		else
+			putchar(*s);
+	}
+	puts("'");
+}
+
+static void dmi_export_number(const char *name, unsigned long long n)
+{
+	printf("%s='%llu'\n", name, n);
+}
+
+void dmi_export(const struct dmi_index *idx, u16 ver)
+{
+	unsigned long long memory_size = 0;
+	unsigned int sockets = 0, processors = 0, cores = 0, threads = 0;
+	unsigned int memory_devices = 0, oem_strings = 0;
+	char buf[80];
+	unsigned int i, k, s;
+
+	for (k = 0; k < opt_string_keyword_count; k++)
+	{
+		const struct string_keyword *key = &opt_string_keyword[k];
+
+		dmi_export_name(key->keyword);
+		putchar('=');
+		dmi_export_value(dmi_keyword_value(idx, NULL, key, ver,
+						   buf, sizeof(buf)));
+	}
+
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+		unsigned long long size;
+
+		switch (h->type)
+		{
+			case 4: /* 7.5 Processor Information */
+				if (h->length < 0x1A)
+					break;
+				sockets++;
+				if (!(h->data[0x18] & (1 << 6)))
+					break;
+				processors++;
+				cores += dmi_processor_count(h, 0x23);
+				threads += dmi_processor_count(h, 0x25);
+				break;
+
+			case 11: /* 7.12 OEM Strings */
+				if (h->length < 5)
+					break;
+				for (s = 1; s <= h->data[4]; s++)
+				{
+					printf("OEM_STRING_%u=", ++oem_strings);
+					dmi_export_value(dmi_string(h, s));
+				}
+				break;
+
+			case 17: /* 7.18 Memory Device */
+				size = dmi_memory_device_size_kb(h);
+				if (size == 0)
+					break;
+				memory_devices++;
+				memory_size += size;
+				break;
+		}
+	}
+
+	dmi_export_number("OEM_STRING_COUNT", oem_strings);
+	dmi_export_number("PROCESSOR_SOCKET_COUNT", sockets);
+	dmi_export_number("PROCESSOR_COUNT", processors);
+	dmi_export_number("PROCESSOR_CORE_COUNT", cores);
+	dmi_export_number("PROCESSOR_THREAD_COUNT", threads);
+	dmi_export_number("MEMORY_DEVICE_COUNT", memory_devices);
+	dmi_export_number("MEMORY_SIZE_MB", memory_size >> 10);
+}
+
+/*
+ * Records of values, as shell variables or JSON object members. Variable
+ * names are the keys in upper case, after the given prefix.
+ */
+
+static int dmi_record_first;	/* No member was displayed yet (JSON) */
+static int dmi_record_indent;	/* Of the members (JSON) */
+
+/* Start a record, members are indented by indent spaces (JSON) */
+void dmi_record_begin(int indent)
+{
+	dmi_record_first = 1;
+	dmi_record_indent = indent;
+}
+
+static void dmi_record_key(const char *prefix, const char *key)
+{
+	if (opt.flags & FLAG_JSON)
+	{
+		printf("%s\n%*s", dmi_record_first ? "" : ",",
+		       dmi_record_indent, "");
+		pr_json_string(key);
+		printf(": ");
+		dmi_record_first = 0;
+	}
+	else
+	{
+		fputs(prefix, stdout);
+		dmi_export_name(key);
+		putchar('=');
+	}
+}
+
+void dmi_record_string(const char *prefix, const char *key, const char *value)
+{
+	dmi_record_key(prefix, key);
+	if (opt.flags & FLAG_JSON)
+		pr_json_string(value);
+	else
+		dmi_export_value(value);
+}
+
+void dmi_record_number(const char *prefix, const char *key,
+		       unsigned long long value)
+{
+	dmi_record_key(prefix, key);
+	if (opt.flags & FLAG_JSON)
+		printf("%llu", value);
+	else
+		printf("'%llu'\n", value);
+}
+
+/* Handles are numbers in JSON, and hexadecimal like when decoding else */
+void dmi_record_handle(const char *prefix, const char *key, u16 handle)
+{
+	dmi_record_key(prefix, key);
+	if (opt.flags & FLAG_JSON)
+		printf("%u", handle);
+	else
+		printf("'0x%04X'\n", handle);
+}
@@ -0,0 +1,37 @@
+/*
+ * Machine-readable exports of DMI tables
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+#include "dmidecode.h"
+
+struct string_keyword;
+
+int dmi_csv_has_fields(u8 type);
+void dmi_csv_header(u8 type);
+void dmi_csv_row(const char *source, const struct dmi_header *h, u16 ver);
+const char *dmi_keyword_value(const struct dmi_index *idx,
+			      const struct dmi_header *h,
+			      const struct string_keyword *key, u16 ver,
+			      char *buf, size_t size);
+const char *dmi_oem_string(const struct dmi_index *idx, unsigned int n);
+void dmi_export(const struct dmi_index *idx, u16 ver);
+void dmi_record_begin(int indent);
+void dmi_record_string(const char *prefix, const char *key, const char *value);
+void dmi_record_number(const char *prefix, const char *key,
+		       unsigned long long value);
+void dmi_record_handle(const char *prefix, const char *key, u16 handle);
@@ -0,0 +1,69 @@
+/*
+ * User-defined output templates
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * The --format template is printed once, or once per entry of the type
+ * of its fields if it has any.
+ */
+
+#include <stdio.h>
+
+#include "types.h"
+#include "dmidecode.h"
+#include "dmiopt.h"
+#include "dmiexport.h"
+#include "dmiformat.h"
+
+/*
+ * Print one line of the --format template. Fields are taken from h, which
+ * is NULL if the template has no fields.
+ */
+void dmi_format_print(const struct dmi_index *idx, const struct dmi_header *h,
+		      u16 ver)
+{
+	const char *value;
+	char buf[80];
+	unsigned int i;
+
+	for (i = 0; i < opt.format_count; i++)
+	{
+		const struct format_item *item = &opt.format[i];
+
+		switch (item->kind)
+		{
+			case FORMAT_TEXT:
+				value = item->text;
+				break;
+			case FORMAT_STRING:
+				value = dmi_keyword_value(idx, h, item->string,
+							  ver, buf, sizeof(buf));
+				break;
+			case FORMAT_FIELD:
+				value = dmi_field_value(item->field, h, ver,
+							buf, sizeof(buf));
+				break;
+			case FORMAT_OEM:
+				value = dmi_oem_string(idx, item->oem);
+				break;
+			default:
+				value = NULL;
+		}
+		if (value != NULL)
+			fputs(value, stdout);
+	}
+	putchar('\n');
+}
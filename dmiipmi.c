@@ -0,0 +1,76 @@
+/*
+ * IPMI device discovery
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * The IPMI export has the values of the first IPMI Device Information
+ * entry (type 38), as IPMI_<KEY> shell variables or as a JSON object. The
+ * table is not walked any further than this entry, and all keys are
+ * always present.
+ */
+
+#include <stdio.h>
+
+#include "types.h"
+#include "dmidecode.h"
+#include "dmiopt.h"
+#include "dmiexport.h"
+#include "dmiipmi.h"
+
+/* 7.39 The first IPMI Device Information entry, h is NULL if there is none */
+void dmi_ipmi(const struct dmi_header *h)
+{
+	const char *prefix = "IPMI_";
+	const u8 *data;
+	char buf[20];
+	const char *space;
+
+	if (h == NULL || h->length < 0x10)
+	{
+		if (opt.flags & FLAG_JSON)
+			printf("null\n");
+		else
+			dmi_record_number(prefix, "present", 0);
+		return;
+	}
+	data = h->data;
+
+	if (opt.flags & FLAG_JSON)
+	{
+		printf("{");
+		dmi_record_begin(2);
+	}
+	else
+		dmi_record_number(prefix, "present", 1);
+	dmi_record_handle(prefix, "handle", h->handle);
+	dmi_record_string(prefix, "interface_type",
+			  dmi_ipmi_interface_type(data[0x04]));
+	snprintf(buf, sizeof(buf), "%u.%u", data[0x05] >> 4, data[0x05] & 0x0F);
+	dmi_record_string(prefix, "specification_version", buf);
+	snprintf(buf, sizeof(buf), "0x%02x", data[0x06] >> 1);
+	dmi_record_string(prefix, "i2c_slave_address", buf);
+	space = dmi_ipmi_base_address_value(data[0x04], data + 0x08,
+		h->length < 0x11 ? 0 : (data[0x10] >> 4) & 1, buf, sizeof(buf));
+	dmi_record_string(prefix, "base_address", buf);
+	dmi_record_string(prefix, "address_space", space);
+	dmi_record_string(prefix, "register_spacing",
+			  h->length < 0x12 || data[0x04] == 0x04 ? "" :
+			  dmi_ipmi_register_spacing(data[0x10] >> 6));
+	dmi_record_number(prefix, "interrupt_number",
+			  h->length < 0x12 ? 0 : data[0x11]);
+	if (opt.flags & FLAG_JSON)
+		printf("\n}\n");
+}
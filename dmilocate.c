@@ -0,0 +1,245 @@
+/*
+ * Physical address to memory device mapping
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * The ranges of the Memory Device Mapped Address structures (type 20) are
+ * kept in an interval tree, so that each address is resolved in
+ * logarithmic time even on systems with many memory devices. The tree is
+ * implicit: the ranges are sorted by starting address, the root of any
+ * slice of the array is its middle element, and each element records the
+ * highest ending address of the subtree it is the root of.
+ *
+ * Ranges may overlap when memory is interleaved, in which case all the
+ * matching memory devices are reported.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "dmidecode.h"
+#include "dmiopt.h"
+#include "dmilocate.h"
+
+struct dmi_locate_range
+{
+	unsigned long long start;
+	unsigned long long end;		/* Inclusive */
+	unsigned long long max_end;	/* Of the subtree */
+	const struct dmi_header *device;	/* Type 17, NULL if unknown */
+};
+
+static int dmi_locate_cmp(const void *a, const void *b)
+{
+	const struct dmi_locate_range *ra = a, *rb = b;
+
+	if (ra->start != rb->start)
+		return ra->start < rb->start ? -1 : 1;
+	if (ra->end != rb->end)
+		return ra->end < rb->end ? -1 : 1;
+	return 0;
+}
+
+static unsigned long long dmi_locate_qword(const u8 *p)
+{
+	return ((unsigned long long)DWORD(p + 4) << 32) | DWORD(p);
+}
+
+/*
+ * 7.20 and 7.21 Address range of a Memory Array Mapped Address (type 19)
+ * or Memory Device Mapped Address (type 20) structure. Returns 0 if the
+ * range is invalid.
+ */
+static int dmi_locate_bounds(const struct dmi_header *h,
+			     unsigned long long *start, unsigned long long *end)
+{
+	u8 extended = h->type == 19 ? 0x0F : 0x13;
+
+	if (h->length < extended)
+		return 0;
+	if (h->length >= extended + 0x10 && DWORD(h->data + 0x04) == 0xFFFFFFFF)
+	{
+		*start = dmi_locate_qword(h->data + extended);
+		*end = dmi_locate_qword(h->data + extended + 0x08);
+	}
+	else
+	{
+		*start = (unsigned long long)DWORD(h->data + 0x04) << 10;
+		*end = ((unsigned long long)DWORD(h->data + 0x08) << 10) + 0x3FF;
+	}
+	return *end >= *start;
+}
+
+/* Returns the number of ranges, -1 on error */
+static int dmi_locate_ranges(const struct dmi_index *idx,
+			     struct dmi_locate_range **ranges)
+{
+	struct dmi_locate_range *r;
+	unsigned int i, count = 0;
+
+	if ((r = malloc((idx->count + 1) * sizeof(*r))) == NULL)
+	{
+		perror("malloc");
+		return -1;
+	}
+
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+		const struct dmi_index_entry *dev;
+
+		if (h->type != 20
+		 || !dmi_locate_bounds(h, &r[count].start, &r[count].end))
+			continue;
+
+		dev = dmi_index_find(idx, WORD(h->data + 0x0C));
+		r[count].device = dev != NULL && dev->h.type == 17
+				  && dev->h.length >= 0x12 ? &dev->h : NULL;
+		count++;
+	}
+
+	qsort(r, count, sizeof(*r), dmi_locate_cmp);
+	*ranges = r;
+	return count;
+}
+
+static unsigned long long dmi_locate_build(struct dmi_locate_range *r,
+					   unsigned int lo, unsigned int hi)
+{
+	unsigned int mid = lo + (hi - lo) / 2;
+	unsigned long long max;
+
+	if (lo >= hi)
+		return 0;
+
+	r[mid].max_end = r[mid].end;
+	max = dmi_locate_build(r, lo, mid);
+	if (max > r[mid].max_end)
+		r[mid].max_end = max;
+	max = dmi_locate_build(r, mid + 1, hi);
+	if (max > r[mid].max_end)
+		r[mid].max_end = max;
+	return r[mid].max_end;
+}
+
+static unsigned int dmi_locate_query(const struct dmi_locate_range *r,
+				     unsigned int lo, unsigned int hi,
+				     unsigned long long addr)
+{
+	unsigned int mid, found;
+
+	if (lo >= hi)
+		return 0;
+	mid = lo + (hi - lo) / 2;
+	if (r[mid].max_end < addr)
+		return 0;
+
+	found = dmi_locate_query(r, lo, mid, addr);
+	if (r[mid].start > addr)
+		return found;
+	if (addr <= r[mid].end)
+	{
+		const struct dmi_header *d = r[mid].device;
+
+		if (d != NULL)
+			printf("0x%016llX\t%s\t%s\n", addr,
+			       dmi_string(d, d->data[0x10]),
+			       dmi_string(d, d->data[0x11]));
+		else
+			printf("0x%016llX\tUnknown\tUnknown\n", addr);
+		found++;
+	}
+	return found + dmi_locate_query(r, mid + 1, hi, addr);
+}
+
+static void dmi_locate_address(const struct dmi_locate_range *r,
+			       unsigned int count, unsigned long long addr)
+{
+	if (dmi_locate_query(r, 0, count, addr) == 0)
+		printf("0x%016llX\tNot Mapped\n", addr);
+}
+
+/*
+ * Read one address per line, blank lines and lines starting with # are
+ * ignored.
+ */
+static void dmi_locate_stdin(const struct dmi_locate_range *r,
+			     unsigned int count)
+{
+	unsigned long long addr;
+	char line[256], *p;
+
+	/* The answers are expected as soon as the addresses are sent */
+	setvbuf(stdout, NULL, _IOLBF, 0);
+
+	while (fgets(line, sizeof(line), stdin) != NULL)
+	{
+		for (p = line; isspace((unsigned char)*p); p++)
+			;
+		if (*p == '\0' || *p == '#')
+			continue;
+		if (parse_address(p, &addr) < 0)
+		{
+			p[strcspn(p, "\r\n")] = '\0';
+			fprintf(stderr, "Invalid address: %s\n", p);
+			continue;
+		}
+		dmi_locate_address(r, count, addr);
+	}
+}
+
+void dmi_locate(const struct dmi_index *idx)
+{
+	struct dmi_locate_range *r;
+	unsigned int i;
+	int count;
+
+	if ((count = dmi_locate_ranges(idx, &r)) < 0)
+		return;
+	dmi_locate_build(r, 0, count);
+
+	for (i = 0; i < opt.locate_count; i++)
+		dmi_locate_address(r, count, opt.locate[i]);
+	if (opt.flags & FLAG_LOCATE_STDIN)
+		dmi_locate_stdin(r, count);
+
+	free(r);
+}
+
+/*
+ * First structure of the given type (19 or 20) which maps a physical
+ * address, NULL if there is none. This is a linear search, for callers
+ * which only resolve a few addresses.
+ */
+const struct dmi_header *dmi_locate_entry(const struct dmi_index *idx,
+					  u8 type, unsigned long long addr)
+{
+	unsigned long long start, end;
+	unsigned int i;
+
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+
+		if (h->type == type && dmi_locate_bounds(h, &start, &end)
+		 && addr >= start && addr <= end)
+			return h;
+	}
+	return NULL;
+}
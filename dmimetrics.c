@@ -0,0 +1,350 @@
+/*
+ * Prometheus metrics
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * The Prometheus export follows the text exposition format, as expected
+ * by the textfile collector of node_exporter. Info series have one label
+ * per field of the type, named after the field; gauges are labelled with
+ * the strings which identify the entry, and values are in base units.
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "types.h"
+#include "util.h"
+#include "dmidecode.h"
+#include "dmimetrics.h"
+
+static void dmi_prom_escape(FILE *f, const char *s)
+{
+	for (; *s; s++)
+	{
+		if (*s == '\\' || *s == '"')
+			fputc('\\', f);
+		if (*s == '\n')
+			fputs("\\n", f);
+		else
+			fputc(*s, f);
+	}
+}
+
+/* Label names are field names in lower case, with _ as separator */
+static void dmi_prom_label_name(FILE *f, const char *s)
+{
+	for (; *s; s++)
+		fputc(isalnum((unsigned char)*s) ? tolower((unsigned char)*s)
+						  : '_', f);
+}
+
+static void dmi_prom_family(FILE *f, const char *name, const char *help)
+{
+	fprintf(f, "# HELP %s %s\n", name, help);
+	fprintf(f, "# TYPE %s gauge\n", name);
+}
+
+static const struct
+{
+	u8 type;
+	const char *name;
+	const char *help;
+} dmi_prom_infos[] = {
+	{ 0, "dmi_bios_info", "BIOS information." },
+	{ 1, "dmi_system_info", "System information." },
+	{ 2, "dmi_baseboard_info", "Base board information." },
+	{ 3, "dmi_chassis_info", "Chassis information." },
+	{ 4, "dmi_processor_info", "Processor information." },
+	{ 17, "dmi_memory_device_info", "Memory device information." },
+};
+
+static void dmi_prom_info(FILE *f, const struct dmi_index *idx, u16 ver,
+			  u8 type, const char *name)
+{
+	const char *value;
+	char buf[80];
+	unsigned int i, j;
+
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+
+		if (h->type != type)
+			continue;
+
+		fprintf(f, "%s{handle=\"0x%04X\"", name, h->handle);
+		for (j = 0; j < dmi_field_count; j++)
+		{
+			if (dmi_fields[j].type != type)
+				continue;
+			value = dmi_field_value(&dmi_fields[j], h, ver,
+						buf, sizeof(buf));
+			if (value == NULL)
+				continue;
+			fputc(',', f);
+			dmi_prom_label_name(f, dmi_fields[j].name);
+			fputs("=\"", f);
+			dmi_prom_escape(f, value);
+			fputc('"', f);
+		}
+		fputs("} 1\n", f);
+	}
+}
+
+/* Value getters return 0 if the value is unknown or not applicable */
+
+static int dmi_prom_processor_populated(const struct dmi_header *h)
+{
+	return h->length >= 0x1A && (h->data[0x18] & (1 << 6));
+}
+
+static int dmi_prom_processor_cores(const struct dmi_header *h, double *v)
+{
+	if (!dmi_prom_processor_populated(h))
+		return 0;
+	*v = dmi_processor_count(h, 0x23);
+	return *v != 0;
+}
+
+static int dmi_prom_processor_threads(const struct dmi_header *h, double *v)
+{
+	if (!dmi_prom_processor_populated(h))
+		return 0;
+	*v = dmi_processor_count(h, 0x25);
+	return *v != 0;
+}
+
+static int dmi_prom_processor_speed(const struct dmi_header *h, double *v)
+{
+	if (!dmi_prom_processor_populated(h) || WORD(h->data + 0x16) == 0)
+		return 0;
+	*v = WORD(h->data + 0x16) * 1e6;
+	return 1;
+}
+
+static int dmi_prom_memory_size(const struct dmi_header *h, double *v)
+{
+	/* Not installed is 0, unknown is skipped */
+	if (h->length < 0x0E || WORD(h->data + 0x0C) == 0xFFFF)
+		return 0;
+	*v = dmi_memory_device_size_kb(h) * 1024.0;
+	return 1;
+}
+
+static int dmi_prom_memory_speed_at(const struct dmi_header *h, u8 offset,
+				    u8 ext, double *v)
+{
+	u32 code;
+
+	if (h->length < offset + 2 || WORD(h->data + 0x0C) == 0)
+		return 0;
+	code = WORD(h->data + offset);
+	if (code == 0xFFFF)
+		code = h->length >= 0x5C ? DWORD(h->data + ext) : 0;
+	*v = code * 1e6;
+	return code != 0;
+}
+
+static int dmi_prom_memory_speed(const struct dmi_header *h, double *v)
+{
+	return dmi_prom_memory_speed_at(h, 0x15, 0x54, v);
+}
+
+static int dmi_prom_memory_configured_speed(const struct dmi_header *h,
+					    double *v)
+{
+	return dmi_prom_memory_speed_at(h, 0x20, 0x58, v);
+}
+
+static int dmi_prom_power_supply_capacity(const struct dmi_header *h,
+					  double *v)
+{
+	if (h->length < 0x10 || WORD(h->data + 0x0C) == 0x8000)
+		return 0;
+	*v = WORD(h->data + 0x0C);
+	return 1;
+}
+
+/* Nominal values of voltage (mV), temperature (0.1 C) and current (mA) */
+static int dmi_prom_probe_nominal(const struct dmi_header *h, double *v)
+{
+	if (h->length < 0x16 || WORD(h->data + 0x14) == 0x8000)
+		return 0;
+	*v = (i16)WORD(h->data + 0x14) / (h->type == 28 ? 10.0 : 1000.0);
+	return 1;
+}
+
+static int dmi_prom_cooling_speed(const struct dmi_header *h, double *v)
+{
+	if (h->length < 0x0E || WORD(h->data + 0x0C) == 0x8000)
+		return 0;
+	*v = WORD(h->data + 0x0C);
+	return 1;
+}
+
+static const struct
+{
+	u8 type;
+	const char *name;
+	const char *help;
+	const char *label[2];	/* Names of the labels, NULL if unused */
+	u8 offset[2];		/* Offsets of their strings */
+	int (*value)(const struct dmi_header *h, double *v);
+} dmi_prom_gauges[] = {
+	{ 4, "dmi_processor_core_count", "Number of cores of the processor.",
+	  { "socket_designation", NULL }, { 0x04, 0 },
+	  dmi_prom_processor_cores },
+	{ 4, "dmi_processor_thread_count", "Number of threads of the processor.",
+	  { "socket_designation", NULL }, { 0x04, 0 },
+	  dmi_prom_processor_threads },
+	{ 4, "dmi_processor_current_speed_hertz", "Current speed of the processor.",
+	  { "socket_designation", NULL }, { 0x04, 0 },
+	  dmi_prom_processor_speed },
+	{ 17, "dmi_memory_device_size_bytes", "Size of the memory device, 0 if not installed.",
+	  { "locator", "bank_locator" }, { 0x10, 0x11 },
+	  dmi_prom_memory_size },
+	{ 17, "dmi_memory_device_speed_transfers_per_second", "Maximum speed of the memory device.",
+	  { "locator", "bank_locator" }, { 0x10, 0x11 },
+	  dmi_prom_memory_speed },
+	{ 17, "dmi_memory_device_configured_speed_transfers_per_second", "Configured speed of the memory device.",
+	  { "locator", "bank_locator" }, { 0x10, 0x11 },
+	  dmi_prom_memory_configured_speed },
+	{ 26, "dmi_voltage_probe_nominal_volts", "Nominal value of the voltage probe.",
+	  { "description", NULL }, { 0x04, 0 },
+	  dmi_prom_probe_nominal },
+	{ 27, "dmi_cooling_device_nominal_speed_rpm", "Nominal speed of the cooling device.",
+	  { "description", NULL }, { 0x0E, 0 },
+	  dmi_prom_cooling_speed },
+	{ 28, "dmi_temperature_probe_nominal_celsius", "Nominal value of the temperature probe.",
+	  { "description", NULL }, { 0x04, 0 },
+	  dmi_prom_probe_nominal },
+	{ 29, "dmi_electrical_current_probe_nominal_amperes", "Nominal value of the electrical current probe.",
+	  { "description", NULL }, { 0x04, 0 },
+	  dmi_prom_probe_nominal },
+	{ 39, "dmi_power_supply_capacity_watts", "Maximum power capacity of the power supply.",
+	  { "location", "name" }, { 0x05, 0x06 },
+	  dmi_prom_power_supply_capacity },
+};
+
+static void dmi_prometheus(FILE *f, const struct dmi_index *idx, u16 ver)
+{
+	unsigned int g, i, l;
+	double v;
+
+	for (g = 0; g < ARRAY_SIZE(dmi_prom_infos); g++)
+	{
+		dmi_prom_family(f, dmi_prom_infos[g].name,
+				dmi_prom_infos[g].help);
+		dmi_prom_info(f, idx, ver, dmi_prom_infos[g].type,
+			      dmi_prom_infos[g].name);
+	}
+
+	for (g = 0; g < ARRAY_SIZE(dmi_prom_gauges); g++)
+	{
+		dmi_prom_family(f, dmi_prom_gauges[g].name,
+				dmi_prom_gauges[g].help);
+		for (i = 0; i < idx->count; i++)
+		{
+			const struct dmi_header *h = &idx->entry[i].h;
+
+			if (h->type != dmi_prom_gauges[g].type
+			 || !dmi_prom_gauges[g].value(h, &v))
+				continue;
+
+			fprintf(f, "%s{handle=\"0x%04X\"",
+				dmi_prom_gauges[g].name, h->handle);
+			for (l = 0; l < 2 && dmi_prom_gauges[g].label[l]; l++)
+			{
+				u8 offset = dmi_prom_gauges[g].offset[l];
+
+				fprintf(f, ",%s=\"", dmi_prom_gauges[g].label[l]);
+				if (offset < h->length)
+					dmi_prom_escape(f, dmi_string(h, h->data[offset]));
+				fputc('"', f);
+			}
+			fprintf(f, "} %.15g\n", v);
+		}
+	}
+}
+
+/*
+ * Write the metrics to path, or to stdout if path is "-". The file is
+ * written under a temporary name first, then renamed, so that the
+ * collector never reads a partial file.
+ */
+int dmi_prometheus_write(const char *path, const struct dmi_index *idx,
+			 u16 ver)
+{
+	char *tmp;
+	FILE *f;
+	int fd;
+
+	if (strcmp(path, "-") == 0)
+	{
+		dmi_prometheus(stdout, idx, ver);
+		return 0;
+	}
+
+	if ((tmp = malloc(strlen(path) + 8)) == NULL)
+	{
+		perror("malloc");
+		return -1;
+	}
+	sprintf(tmp, "%s.XXXXXX", path);
+
+	if ((fd = mkstemp(tmp)) == -1)
+	{
+		fprintf(stderr, "%s: ", tmp);
+		perror("mkstemp");
+		free(tmp);
+		return -1;
+	}
+	/* The collector typically doesn't run as root */
+	if (fchmod(fd, 0644) == -1 || (f = fdopen(fd, "w")) == NULL)
+	{
+		fprintf(stderr, "%s: ", tmp);
+		perror("fdopen");
+		close(fd);
+		goto err;
+	}
+
+	dmi_prometheus(f, idx, ver);
+	if (ferror(f) | fclose(f))
+	{
+		fprintf(stderr, "%s: ", tmp);
+		perror("fwrite");
+		goto err;
+	}
+	if (rename(tmp, path) == -1)
+	{
+		fprintf(stderr, "%s: ", path);
+		perror("rename");
+		goto err;
+	}
+
+	free(tmp);
+	return 0;
+
+err:
+	unlink(tmp);
+	free(tmp);
+	return -1;
+}
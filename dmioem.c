@@ -47,6 +47,7 @@ enum DMI_VENDORS
 
 static enum DMI_VENDORS dmi_vendor = VENDOR_UNKNOWN;
 static const char *dmi_product = NULL;
+static u8 dmi_hp_nic_ctr;
 
 /*
  * Remember the system vendor for later use. We only actually store the
@@ -252,16 +253,15 @@ static int dmi_decode_dell(const struct dmi_header *h)
 
 static void dmi_print_hp_net_iface_rec(u8 id, u8 bus, u8 dev, const u8 *mac)
 {
-	/* Some systems do not provide an id. nic_ctr provides an artificial
-	 * id, and assumes the records will be provided "in order".  Also,
-	 * using 0xFF marker is not future proof. 256 NICs is a lot, but
+	/* Some systems do not provide an id. dmi_hp_nic_ctr provides an
+	 * artificial id, and assumes the records will be provided "in order".
+	 * Also, using 0xFF marker is not future proof. 256 NICs is a lot, but
 	 * 640K ought to be enough for anybody(said no one, ever).
 	 * */
-	static u8 nic_ctr;
 	char attr[8];
 
 	if (id == 0xFF)
-		id = ++nic_ctr;
+		id = ++dmi_hp_nic_ctr;
 
 	sprintf(attr, "NIC %hhu", id);
 	if (dev == 0x00 && bus == 0x00)
@@ -830,22 +830,22 @@ static void dmi_hp_239_usb_device(u8 class, u8 subclass, u8 protocol)
 
 static void dmi_hp_240_attr(u64 defined, u64 set)
 {
-	static const char *attributes[] = {
+	static const char * const attributes[] = {
 		"Updatable",
 		"Reset Required",
 		"Authentication Required",
 		"In Use",
 		"UEFI Image",
 	};
-	unsigned int i;
+	static const struct dmi_bitfield bits = {
+		0, ARRAY_SIZE(attributes), attributes
+	};
+	u32 code = defined.l;
+	int i;
 
 	pr_list_start("Attributes Defined/Set", NULL);
-	for (i = 0; i < ARRAY_SIZE(attributes); i++)
-	{
-		if (!(defined.l & (1UL << i)))
-			continue;
+	while ((i = dmi_bitfield_next(&bits, &code)) >= 0)
 		pr_list_item("%s: %s", attributes[i], set.l & (1UL << i) ? "Yes" : "No");
-	}
 	pr_list_end();
 }
 
@@ -929,6 +929,15 @@ static void dmi_hp_245_pcie_riser(const struct dmi_header *h)
 	pr_attr("Riser Name", dmi_string(h, data[0x08]));
 }
 
+/*
+ * NIC number of a type 233 record. If the record isn't long enough, we
+ * don't have an ID, use 0xFF to use the internal counter.
+ */
+static u8 dmi_hp_233_nic(const struct dmi_header *h)
+{
+	return h->length > 0x28 ? h->data[0x28] : 0xFF;
+}
+
 static int dmi_decode_hp(const struct dmi_header *h)
 {
 	u8 *data = h->data;
@@ -1372,10 +1381,7 @@ static int dmi_decode_hp(const struct dmi_header *h)
 			pr_handle_name("%s BIOS PXE NIC PCI and MAC Information",
 				       company);
 			if (h->length < 0x0E) break;
-			/* If the record isn't long enough, we don't have an ID
-			 * use 0xFF to use the internal counter.
-			 * */
-			nic = h->length > 0x28 ? data[0x28] : 0xFF;
+			nic = dmi_hp_233_nic(h);
 			dmi_print_hp_net_iface_rec(nic, data[0x06], data[0x07],
 						   &data[0x08]);
 			if (h->length < 0x2A) break;
@@ -1815,6 +1821,28 @@ static int dmi_decode_ibm_lenovo(const struct dmi_header *h)
 	return 1;
 }
 
+/*
+ * Account for a structure which would have been decoded, but was decoded
+ * by another process instead, so that state carried from one structure to
+ * the next is still right.
+ */
+void dmi_skip_oem(const struct dmi_header *h)
+{
+	switch (dmi_vendor)
+	{
+		case VENDOR_HP:
+		case VENDOR_HPE:
+			/* Type 233 records without an ID use a counter */
+			if (h->type == 233 && h->length >= 0x0E
+			 && dmi_hpegen(dmi_product) >= 0
+			 && dmi_hp_233_nic(h) == 0xFF)
+				dmi_hp_nic_ctr++;
+			break;
+		default:
+			break;
+	}
+}
+
 /*
  * Dispatch vendor-specific entries decoding
  * Return 1 if decoding was successful, 0 otherwise
@@ -23,3 +23,4 @@ struct dmi_header;
 
 void dmi_set_vendor(const char *s, const char *p);
 int dmi_decode_oem(const struct dmi_header *h);
+void dmi_skip_oem(const struct dmi_header *h);
@@ -0,0 +1,125 @@
+/*
+ * OEM string key lookup
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * The OEM key index maps the keys of the OEM strings of the form
+ * key=value or key:value to their value. A string is indexed under the
+ * text before its first = and the text before its first :, so that
+ * "io.systemd.credential:name=value" can be looked up either way. When a
+ * key is found more than once, the first string wins.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "util.h"
+#include "dmidecode.h"
+#include "dmiopt.h"
+#include "dmioemkey.h"
+
+struct dmi_oem_key
+{
+	const char *key;	/* Not terminated */
+	size_t len;
+	const char *value;
+};
+
+static unsigned long long dmi_oem_key_hash(const char *key, size_t len)
+{
+	return hash64(key, len, HASH64_INIT);
+}
+
+/* Open addressing, size is a power of 2 and more than twice the keys */
+static void dmi_oem_key_add(struct dmi_oem_key *table, size_t size,
+			    const char *s, const char *sep)
+{
+	size_t len = sep - s, i;
+
+	i = dmi_oem_key_hash(s, len) & (size - 1);
+	while (table[i].key != NULL)
+	{
+		if (table[i].len == len && memcmp(table[i].key, s, len) == 0)
+			return;
+		i = (i + 1) & (size - 1);
+	}
+	table[i].key = s;
+	table[i].len = len;
+	table[i].value = sep + 1;
+}
+
+static const char *dmi_oem_key_find(const struct dmi_oem_key *table,
+				    size_t size, const char *key)
+{
+	size_t len = strlen(key), i;
+
+	i = dmi_oem_key_hash(key, len) & (size - 1);
+	while (table[i].key != NULL)
+	{
+		if (table[i].len == len && memcmp(table[i].key, key, len) == 0)
+			return table[i].value;
+		i = (i + 1) & (size - 1);
+	}
+	return NULL;
+}
+
+/* One line per requested key, empty if the key isn't found */
+void dmi_oem_keys(const struct dmi_index *idx)
+{
+	struct dmi_oem_key *table;
+	size_t size = 16;
+	unsigned int strings = 0, i;
+	const char *value, *sep;
+	u8 n;
+
+	for (i = 0; i < idx->count; i++)
+		if (idx->entry[i].h.type == 11 && idx->entry[i].h.length >= 5)
+			strings += idx->entry[i].h.data[4];
+	while (size <= 4 * (size_t)strings)
+		size <<= 1;
+	if ((table = calloc(size, sizeof(*table))) == NULL)
+	{
+		perror("calloc");
+		return;
+	}
+
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+
+		if (h->type != 11 || h->length < 5)
+			continue;
+		for (n = 1; n != 0 && n <= h->data[4]; n++)
+		{
+			const char *s = dmi_string(h, n);
+
+			if ((sep = strchr(s, '=')) != NULL)
+				dmi_oem_key_add(table, size, s, sep);
+			if ((sep = strchr(s, ':')) != NULL)
+				dmi_oem_key_add(table, size, s, sep);
+		}
+	}
+
+	for (i = 0; i < opt.oem_key_count; i++)
+	{
+		value = dmi_oem_key_find(table, size, opt.oem_key[i]);
+		printf("%s\n", value != NULL ? value : "");
+	}
+
+	free(table);
+}
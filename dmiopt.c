@@ -19,6 +19,8 @@
  *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
  */
 
+#include <ctype.h>
+#include <errno.h>
 #include <stdio.h>
 #include <string.h>
 #include <strings.h>
@@ -30,6 +32,8 @@
 #include "util.h"
 #include "dmidecode.h"
 #include "dmiopt.h"
+#include "dmiexport.h"
+#include "dmisummary.h"
 
 
 /* Options are global */
@@ -147,7 +151,7 @@ static u8 *parse_opt_type(u8 *p, const char *arg)
 /* This lookup table could admittedly be reworked for improved performance.
    Due to the low count of items in there at the moment, it did not seem
    worth the additional code complexity though. */
-static const struct string_keyword opt_string_keyword[] = {
+const struct string_keyword opt_string_keyword[] = {
 	{ "bios-vendor", 0, 0x04 },
 	{ "bios-version", 0, 0x05 },
 	{ "bios-release-date", 0, 0x08 },
@@ -157,7 +161,7 @@ static const struct string_keyword opt_string_keyword[] = {
 	{ "system-product-name", 1, 0x05 },
 	{ "system-version", 1, 0x06 },
 	{ "system-serial-number", 1, 0x07 },
-	{ "system-uuid", 1, 0x08 },             /* dmi_system_uuid() */
+	{ "system-uuid", 1, 0x08 },
 	{ "system-sku-number", 1, 0x19 },
 	{ "system-family", 1, 0x1a },
 	{ "baseboard-manufacturer", 2, 0x04 },
@@ -166,16 +170,18 @@ static const struct string_keyword opt_string_keyword[] = {
 	{ "baseboard-serial-number", 2, 0x07 },
 	{ "baseboard-asset-tag", 2, 0x08 },
 	{ "chassis-manufacturer", 3, 0x04 },
-	{ "chassis-type", 3, 0x05 },            /* dmi_chassis_type() */
+	{ "chassis-type", 3, 0x05 },
 	{ "chassis-version", 3, 0x06 },
 	{ "chassis-serial-number", 3, 0x07 },
 	{ "chassis-asset-tag", 3, 0x08 },
-	{ "processor-family", 4, 0x06 },        /* dmi_processor_family() */
+	{ "processor-family", 4, 0x06 },
 	{ "processor-manufacturer", 4, 0x07 },
 	{ "processor-version", 4, 0x10 },
-	{ "processor-frequency", 4, 0x16 },     /* dmi_processor_frequency() */
+	{ "processor-frequency", 4, 0x16 },
 };
 
+const unsigned int opt_string_keyword_count = ARRAY_SIZE(opt_string_keyword);
+
 /* This is a template, 3rd field is set at runtime. */
 static struct string_keyword opt_oem_string_keyword =
 	{ NULL, 11, 0x00 };
@@ -243,6 +249,133 @@ static int parse_opt_oem_string(const char *arg)
 	return 0;
 }
 
+/*
+ * Handling of option --field
+ */
+
+static void print_opt_field_list(FILE *f)
+{
+	unsigned int i;
+
+	for (i = 0; i < dmi_field_count; i++)
+		fprintf(f, "%u.%s\n", dmi_fields[i].type, dmi_fields[i].name);
+}
+
+static int parse_opt_field(const char *arg)
+{
+	unsigned long val;
+	char *next;
+
+	if (opt.field)
+	{
+		fprintf(stderr, "Only one field can be specified\n");
+		return -1;
+	}
+
+	/* Fields are specified as TYPE.NAME */
+	val = strtoul(arg, &next, 10);
+	if (next != arg && *next == '.' && val <= 0xff)
+		opt.field = dmi_field_find(val, next + 1);
+
+	if (opt.field == NULL)
+	{
+		fprintf(stderr, "Invalid field: %s\n", arg);
+		fprintf(stderr, "Valid fields are:\n");
+		print_opt_field_list(stderr);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Handling of option --match
+ */
+
+static int parse_opt_match(const char *arg)
+{
+	struct match_value *m;
+	const struct dmi_field *f = NULL;
+	const char *eq;
+	char name[64];
+	unsigned long val;
+	char *next;
+
+	/* Matches are specified as TYPE.NAME=VALUE */
+	val = strtoul(arg, &next, 10);
+	eq = strchr(arg, '=');
+	if (next != arg && *next == '.' && val <= 0xff && eq != NULL
+	 && eq - next - 1 < (int)sizeof(name))
+	{
+		snprintf(name, sizeof(name), "%.*s", (int)(eq - next - 1),
+			 next + 1);
+		f = dmi_field_find(val, name);
+	}
+
+	if (f == NULL)
+	{
+		fprintf(stderr, "Invalid match: %s\n", arg);
+		fprintf(stderr, "Valid fields are:\n");
+		print_opt_field_list(stderr);
+		return -1;
+	}
+
+	/* All conditions must be met by the same structure */
+	if (opt.match_count && opt.match[0].field->type != f->type)
+	{
+		fprintf(stderr, "All matches must apply to the same type\n");
+		return -1;
+	}
+
+	m = realloc(opt.match, (opt.match_count + 1) * sizeof(*m));
+	if (m == NULL)
+	{
+		perror("realloc");
+		return -1;
+	}
+	opt.match = m;
+	m += opt.match_count;
+
+	m->field = f;
+	m->text = eq + 1;
+	m->raw = 0;
+	m->code = 0;
+
+	/*
+	 * Enumerated and numeric values are turned into a raw value now,
+	 * so that structures can be matched without decoding them.
+	 */
+	if (f->format == FIELD_ENUM)
+	{
+		int code = dmi_enum_code(f->values, m->text);
+
+		if (code < 0)
+		{
+			fprintf(stderr, "Invalid value for field %u.%s: %s\n",
+				f->type, f->name, m->text);
+			return -1;
+		}
+		m->raw = 1;
+		m->code = code;
+	}
+	else if (f->format == FIELD_NUMBER)
+	{
+		val = strtoul(m->text, &next, 0);
+		if (next == m->text || *next != '\0'
+		 || val > (0xFFFFFFFFUL >> (32 - f->width * 8)))
+		{
+			fprintf(stderr, "Invalid value for field %u.%s: %s\n",
+				f->type, f->name, m->text);
+			return -1;
+		}
+		m->raw = 1;
+		m->code = val;
+	}
+
+	opt.match_count++;
+	return 0;
+}
+
 static u32 parse_opt_handle(const char *arg)
 {
 	u32 val;
@@ -257,6 +390,459 @@ static u32 parse_opt_handle(const char *arg)
 	return val;
 }
 
+/*
+ * Handling of option --format
+ */
+
+static int parse_opt_format_item(char *name, struct format_item *item)
+{
+	unsigned long val;
+	unsigned int i;
+	char *next;
+
+	/* Fields, as TYPE.NAME */
+	val = strtoul(name, &next, 10);
+	if (next != name && *next == '.' && val <= 0xff)
+	{
+		item->kind = FORMAT_FIELD;
+		item->field = dmi_field_find(val, next + 1);
+		if (item->field == NULL)
+			return -1;
+		return 0;
+	}
+
+	/* OEM strings, as oem-string:N */
+	if (strncmp(name, "oem-string:", 11) == 0)
+	{
+		val = strtoul(name + 11, &next, 10);
+		if (next == name + 11 || *next != '\0' || val == 0 || val > 0xff)
+			return -1;
+		item->kind = FORMAT_OEM;
+		item->oem = val;
+		return 0;
+	}
+
+	/* String keywords */
+	for (i = 0; i < ARRAY_SIZE(opt_string_keyword); i++)
+	{
+		if (!strcasecmp(name, opt_string_keyword[i].keyword))
+		{
+			item->kind = FORMAT_STRING;
+			item->string = &opt_string_keyword[i];
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+/*
+ * The template is compiled into a list of items once, literal text and
+ * placeholders alternating. Escape sequences in the literal text are
+ * processed in place, in a copy of the template.
+ */
+static int parse_opt_format(const char *arg)
+{
+	struct format_item *item;
+	char *r, *w, *end;
+
+	if (opt.format != NULL)
+	{
+		fprintf(stderr, "Only one format can be specified\n");
+		return -1;
+	}
+
+	/* There can't be more items than characters, plus a final text */
+	opt.format_buf = strdup(arg);
+	opt.format = malloc((strlen(arg) + 1) * sizeof(*opt.format));
+	if (opt.format_buf == NULL || opt.format == NULL)
+	{
+		perror("malloc");
+		return -1;
+	}
+	opt.format_type = -1;
+
+	r = w = opt.format_buf;
+	item = opt.format;
+	item->kind = FORMAT_TEXT;
+	item->text = w;
+	while (*r)
+	{
+		if (*r == '\\' && r[1] != '\0')
+		{
+			r++;
+			switch (*r)
+			{
+				case 'n':
+					*w++ = '\n';
+					break;
+				case 't':
+					*w++ = '\t';
+					break;
+				default:
+					*w++ = *r;
+			}
+			r++;
+			continue;
+		}
+
+		if (*r != '{')
+		{
+			*w++ = *r++;
+			continue;
+		}
+
+		if ((end = strchr(r, '}')) == NULL)
+		{
+			fprintf(stderr, "Unterminated placeholder in format: %s\n", r);
+			return -1;
+		}
+		*end = '\0';
+		*w++ = '\0';
+		item++;
+		if (parse_opt_format_item(r + 1, item) < 0)
+		{
+			fprintf(stderr, "Invalid placeholder in format: {%s}\n",
+				r + 1);
+			fprintf(stderr, "Valid placeholders are string keywords (see --list-strings),\n"
+				"fields (see --list-fields) and oem-string:N\n");
+			return -1;
+		}
+		if (item->kind == FORMAT_FIELD)
+		{
+			if (opt.format_type != -1
+			 && opt.format_type != item->field->type)
+			{
+				fprintf(stderr, "All fields of the format must have the same type\n");
+				return -1;
+			}
+			opt.format_type = item->field->type;
+		}
+		r = end + 1;
+
+		item++;
+		item->kind = FORMAT_TEXT;
+		item->text = w;
+	}
+	*w = '\0';
+	opt.format_count = item - opt.format + 1;
+
+	return 0;
+}
+
+static int parse_opt_csv(const char *arg)
+{
+	unsigned long val;
+	char *next;
+
+	val = strtoul(arg, &next, 0);
+	if (next == arg || *next != '\0' || val > 0xff
+	 || !dmi_csv_has_fields(val))
+	{
+		fprintf(stderr, "Invalid type for --csv: %s\n", arg);
+		fprintf(stderr, "Valid fields are:\n");
+		print_opt_field_list(stderr);
+		return -1;
+	}
+
+	opt.csv_type = val;
+	return 0;
+}
+
+static unsigned int parse_opt_jobs(const char *arg)
+{
+	unsigned long val;
+	char *next;
+
+	val = strtoul(arg, &next, 10);
+	if (next == arg || *next != '\0' || val == 0 || val > 1024)
+	{
+		fprintf(stderr, "Invalid number of jobs: %s\n", arg);
+		return 0;
+	}
+	return val;
+}
+
+static unsigned int parse_opt_watch(const char *arg)
+{
+	unsigned long val;
+	char *next;
+
+	val = strtoul(arg, &next, 10);
+	if (next == arg || *next != '\0' || val == 0 || val > 86400)
+	{
+		fprintf(stderr, "Invalid watch interval: %s\n", arg);
+		return 0;
+	}
+	return val;
+}
+
+/*
+ * Parse a physical address, in hexadecimal with a 0x prefix or in
+ * decimal. Trailing white space is ignored. Return -1 on error, 0 on
+ * success.
+ */
+int parse_address(const char *arg, unsigned long long *addr)
+{
+	char *next;
+
+	if (!isdigit((unsigned char)*arg))
+		return -1;
+	errno = 0;
+	*addr = strtoull(arg, &next, 0);
+	if (errno)
+		return -1;
+	while (isspace((unsigned char)*next))
+		next++;
+	return *next == '\0' ? 0 : -1;
+}
+
+/* Addresses are separated by commas, - means to read them from stdin */
+static int parse_opt_locate(const char *arg)
+{
+	unsigned long long *a;
+	char buf[32];
+	size_t len;
+
+	opt.flags |= FLAG_LOCATE;
+	while (*arg)
+	{
+		len = strcspn(arg, ",");
+		if (len == 1 && *arg == '-')
+			opt.flags |= FLAG_LOCATE_STDIN;
+		else
+		{
+			if (len >= sizeof(buf))
+				len = sizeof(buf) - 1;
+			memcpy(buf, arg, len);
+			buf[len] = '\0';
+
+			a = realloc(opt.locate,
+				    (opt.locate_count + 1) * sizeof(*a));
+			if (a == NULL)
+			{
+				perror("realloc");
+				return -1;
+			}
+			opt.locate = a;
+			if (parse_address(buf, &a[opt.locate_count]) < 0)
+			{
+				fprintf(stderr, "Invalid address: %s\n", buf);
+				return -1;
+			}
+			opt.locate_count++;
+		}
+
+		arg += strcspn(arg, ",");
+		if (*arg == ',')
+			arg++;
+	}
+	return 0;
+}
+
+static int parse_opt_oem_key(const char *arg)
+{
+	const char **k;
+
+	k = realloc(opt.oem_key, (opt.oem_key_count + 1) * sizeof(*k));
+	if (k == NULL)
+	{
+		perror("realloc");
+		return -1;
+	}
+	opt.oem_key = k;
+	k[opt.oem_key_count++] = arg;
+	return 0;
+}
+
+static int parse_opt_event_log_offset(const char *arg)
+{
+	unsigned long val;
+	char *next;
+
+	errno = 0;
+	val = strtoul(arg, &next, 0);
+	if (next == arg || *next != '\0' || errno || val > 0xFFFF)
+	{
+		fprintf(stderr, "Invalid event log offset: %s\n", arg);
+		return -1;
+	}
+	opt.event_log_offset = val;
+	return 0;
+}
+
+/* Summaries are separated by commas */
+static unsigned int parse_opt_summary(const char *arg)
+{
+	unsigned int mask = 0, bit;
+	char buf[32];
+	size_t len;
+
+	while (*arg)
+	{
+		len = strcspn(arg, ",");
+		snprintf(buf, sizeof(buf), "%.*s", (int)len, arg);
+		if ((bit = dmi_summary_bit(buf)) == 0)
+		{
+			fprintf(stderr, "Invalid summary: %s\n", buf);
+			fprintf(stderr, "Valid summaries are:\n");
+			dmi_summary_list(stderr);
+			return 0;
+		}
+		mask |= bit;
+
+		arg += len;
+		if (*arg == ',')
+			arg++;
+	}
+	if (mask == 0)
+		fprintf(stderr, "Invalid summary: %s\n", arg);
+	return mask;
+}
+
+/*
+ * Output modes
+ */
+
+enum mode
+{
+	MODE_DECODE,		/* Default, no option */
+	MODE_DUMP_BIN,
+	MODE_DIFF,
+	MODE_FINGERPRINT,
+	MODE_STORE,
+	MODE_CSV,
+	MODE_EXPORT,
+	MODE_FORMAT,
+	MODE_DAEMON,
+	MODE_PUBLISH,
+	MODE_WATCH,
+	MODE_PROMETHEUS,
+	MODE_LOCATE,
+	MODE_SUMMARY,
+	MODE_TREE,
+	MODE_PCI_MAP,
+	MODE_OEM_KEY,
+	MODE_EVENT_LOG,
+	MODE_REDFISH,
+	MODE_IPMI,
+};
+
+/* Options which change what a mode displays */
+#define MOD_TYPE                (1 << 0)
+#define MOD_HANDLE              (1 << 1)
+#define MOD_STRING              (1 << 2)
+#define MOD_OEM_STRING          (1 << 3)
+#define MOD_FIELD               (1 << 4)
+#define MOD_MATCH               (1 << 5)
+#define MOD_JOBS                (1 << 6)
+#define MOD_DUMP                (1 << 7)
+#define MOD_DUMP_INDEX          (1 << 8)
+#define MOD_REPLACE             (1 << 9)
+#define MOD_JSON                (1 << 10)
+
+static const char * const opt_modifier[] = {
+	"--type",
+	"--handle",
+	"--string",
+	"--oem-string",
+	"--field",
+	"--match",
+	"--jobs",
+	"--dump",
+	"--dump-index",
+	"--replace",
+	"--json",
+};
+
+/*
+ * Modifiers each mode can be combined with, in the order of enum mode.
+ * Options --dev-mem, --quiet, --from-dump, --from-shm, --no-sysfs and
+ * --no-quirks go with all modes.
+ */
+static const struct
+{
+	const char *option;
+	unsigned int modifiers;
+} opt_mode[] = {
+	{ NULL, MOD_TYPE | MOD_HANDLE | MOD_STRING | MOD_OEM_STRING | MOD_FIELD
+		| MOD_MATCH | MOD_JOBS | MOD_DUMP },
+	{ "--dump-bin", MOD_DUMP_INDEX },
+	{ "--diff", MOD_TYPE },
+	{ "--fingerprint", MOD_TYPE },
+	{ "--store", 0 },
+	{ "--csv", MOD_MATCH | MOD_JOBS },
+	{ "--export", 0 },
+	{ "--format", MOD_MATCH },
+	{ "--daemon", MOD_JOBS | MOD_REPLACE },
+	{ "--publish", 0 },
+	{ "--watch", MOD_TYPE },
+	{ "--prometheus", 0 },
+	{ "--locate-address", 0 },
+	{ "--summary", MOD_JSON },
+	{ "--tree", MOD_JSON },
+	{ "--pci-map", 0 },
+	{ "--oem-key", 0 },
+	{ "--event-log", 0 },
+	{ "--redfish", MOD_JSON },
+	{ "--ipmi", MOD_JSON },
+};
+
+/*
+ * Make sure that at most one mode was selected, and that the modifiers
+ * given all go with it. Return -1 on error, 0 on success.
+ */
+static int check_opt_mode(unsigned int modes, unsigned int modifiers)
+{
+	unsigned int mode, other, count, i;
+
+	for (mode = 0; mode < ARRAY_SIZE(opt_mode); mode++)
+		if (modes & (1 << mode))
+			break;
+	if (mode == ARRAY_SIZE(opt_mode))
+		mode = MODE_DECODE;
+	for (other = mode + 1; other < ARRAY_SIZE(opt_mode); other++)
+		if (modes & (1 << other))
+		{
+			fprintf(stderr, "Options %s and %s are mutually exclusive\n",
+				opt_mode[mode].option, opt_mode[other].option);
+			return -1;
+		}
+
+	for (i = 0; i < ARRAY_SIZE(opt_modifier); i++)
+	{
+		if (!(modifiers & ~opt_mode[mode].modifiers & (1 << i)))
+			continue;
+
+		if (mode != MODE_DECODE)
+		{
+			fprintf(stderr, "Option %s can't be used with %s\n",
+				opt_mode[mode].option, opt_modifier[i]);
+			return -1;
+		}
+
+		/* Tell which modes it is meant for */
+		for (count = 0, other = 1; other < ARRAY_SIZE(opt_mode); other++)
+			if (opt_mode[other].modifiers & (1 << i))
+				count++;
+		fprintf(stderr, "Option %s can only be used with ", opt_modifier[i]);
+		for (other = 1; other < ARRAY_SIZE(opt_mode); other++)
+			if (opt_mode[other].modifiers & (1 << i))
+			{
+				fputs(opt_mode[other].option, stderr);
+				count--;
+				if (count > 1)
+					fputs(", ", stderr);
+				else if (count == 1)
+					fputs(" or ", stderr);
+			}
+		fputc('\n', stderr);
+		return -1;
+	}
+
+	return 0;
+}
+
 /*
  * Command line options handling
  */
@@ -265,7 +851,7 @@ static u32 parse_opt_handle(const char *arg)
 int parse_command_line(int argc, char * const argv[])
 {
 	int option;
-	unsigned int i;
+	unsigned int i, modes = 0, modifiers = 0;
 	const char *optstring = "d:hqs:t:uH:V";
 	struct option longopts[] = {
 		{ "dev-mem", required_argument, NULL, 'd' },
@@ -276,12 +862,38 @@ int parse_command_line(int argc, char * const argv[])
 		{ "type", required_argument, NULL, 't' },
 		{ "dump", no_argument, NULL, 'u' },
 		{ "dump-bin", required_argument, NULL, 'B' },
+		{ "dump-index", no_argument, NULL, 'I' },
 		{ "from-dump", required_argument, NULL, 'F' },
+		{ "store", required_argument, NULL, 'A' },
+		{ "diff", required_argument, NULL, 'D' },
+		{ "fingerprint", no_argument, NULL, 'P' },
 		{ "handle", required_argument, NULL, 'H' },
 		{ "oem-string", required_argument, NULL, 'O' },
 		{ "no-sysfs", no_argument, NULL, 'S' },
 		{ "list-strings", no_argument, NULL, 'L' },
 		{ "list-types", no_argument, NULL, 'T' },
+		{ "field", required_argument, NULL, 'f' },
+		{ "list-fields", no_argument, NULL, 'l' },
+		{ "match", required_argument, NULL, 'm' },
+		{ "jobs", required_argument, NULL, 'j' },
+		{ "csv", required_argument, NULL, 'C' },
+		{ "export", no_argument, NULL, 'E' },
+		{ "format", required_argument, NULL, 'M' },
+		{ "daemon", required_argument, NULL, 'N' },
+		{ "replace", no_argument, NULL, 'o' },
+		{ "publish", required_argument, NULL, 'U' },
+		{ "from-shm", required_argument, NULL, 'R' },
+		{ "watch", required_argument, NULL, 'W' },
+		{ "prometheus", required_argument, NULL, 'X' },
+		{ "locate-address", required_argument, NULL, 'Y' },
+		{ "summary", required_argument, NULL, 'Z' },
+		{ "json", no_argument, NULL, 'J' },
+		{ "tree", no_argument, NULL, 'G' },
+		{ "pci-map", no_argument, NULL, 'K' },
+		{ "oem-key", required_argument, NULL, 'k' },
+		{ "event-log", optional_argument, NULL, 'e' },
+		{ "redfish", no_argument, NULL, 'r' },
+		{ "ipmi", no_argument, NULL, 'i' },
 		{ "version", no_argument, NULL, 'V' },
 		{ NULL, 0, NULL, 0 }
 	};
@@ -290,12 +902,37 @@ int parse_command_line(int argc, char * const argv[])
 		switch (option)
 		{
 			case 'B':
+			case 'A':
+				if (opt.flags & FLAG_DUMP_BIN)
+				{
+					fprintf(stderr, "Options --dump-bin and --store can only be used once\n");
+					return -1;
+				}
 				opt.flags |= FLAG_DUMP_BIN;
+				if (option == 'A')
+				{
+					opt.flags |= FLAG_STORE;
+					modes |= 1 << MODE_STORE;
+				}
+				else
+					modes |= 1 << MODE_DUMP_BIN;
 				opt.dumpfile = optarg;
 				break;
 			case 'F':
 				opt.flags |= FLAG_FROM_DUMP;
-				opt.dumpfile = optarg;
+				opt.fromfile = optarg;
+				break;
+			case 'D':
+				opt.diff = optarg;
+				modes |= 1 << MODE_DIFF;
+				break;
+			case 'P':
+				opt.flags |= FLAG_FINGERPRINT;
+				modes |= 1 << MODE_FINGERPRINT;
+				break;
+			case 'I':
+				opt.flags |= FLAG_DUMP_INDEX;
+				modifiers |= MOD_DUMP_INDEX;
 				break;
 			case 'd':
 				opt.devmem = optarg;
@@ -313,24 +950,134 @@ int parse_command_line(int argc, char * const argv[])
 				if (parse_opt_string(optarg) < 0)
 					return -1;
 				opt.flags |= FLAG_QUIET;
+				modifiers |= MOD_STRING;
 				break;
 			case 'O':
 				if (parse_opt_oem_string(optarg) < 0)
 					return -1;
 				opt.flags |= FLAG_QUIET;
+				modifiers |= MOD_OEM_STRING;
+				break;
+			case 'f':
+				if (parse_opt_field(optarg) < 0)
+					return -1;
+				opt.flags |= FLAG_QUIET;
+				modifiers |= MOD_FIELD;
+				break;
+			case 'm':
+				if (parse_opt_match(optarg) < 0)
+					return -1;
+				modifiers |= MOD_MATCH;
 				break;
 			case 't':
 				opt.type = parse_opt_type(opt.type, optarg);
 				if (opt.type == NULL)
 					return -1;
+				modifiers |= MOD_TYPE;
 				break;
 			case 'H':
 				opt.handle = parse_opt_handle(optarg);
 				if (opt.handle  == ~0U)
 					return -1;
+				modifiers |= MOD_HANDLE;
+				break;
+			case 'j':
+				opt.jobs = parse_opt_jobs(optarg);
+				if (opt.jobs == 0)
+					return -1;
+				modifiers |= MOD_JOBS;
+				break;
+			case 'C':
+				if (parse_opt_csv(optarg) < 0)
+					return -1;
+				opt.flags |= FLAG_CSV | FLAG_QUIET;
+				modes |= 1 << MODE_CSV;
+				break;
+			case 'E':
+				opt.flags |= FLAG_EXPORT | FLAG_QUIET;
+				modes |= 1 << MODE_EXPORT;
+				break;
+			case 'M':
+				if (parse_opt_format(optarg) < 0)
+					return -1;
+				opt.flags |= FLAG_FORMAT | FLAG_QUIET;
+				modes |= 1 << MODE_FORMAT;
+				break;
+			case 'N':
+				opt.daemon = optarg;
+				modes |= 1 << MODE_DAEMON;
+				break;
+			case 'o':
+				opt.flags |= FLAG_REPLACE;
+				modifiers |= MOD_REPLACE;
+				break;
+			case 'U':
+				opt.publish = optarg;
+				modes |= 1 << MODE_PUBLISH;
+				break;
+			case 'R':
+				opt.fromshm = optarg;
+				break;
+			case 'X':
+				opt.prometheus = optarg;
+				if (strcmp(optarg, "-") == 0)
+					opt.flags |= FLAG_QUIET;
+				modes |= 1 << MODE_PROMETHEUS;
+				break;
+			case 'Y':
+				if (parse_opt_locate(optarg) < 0)
+					return -1;
+				opt.flags |= FLAG_QUIET;
+				modes |= 1 << MODE_LOCATE;
+				break;
+			case 'Z':
+				opt.summary = parse_opt_summary(optarg);
+				if (opt.summary == 0)
+					return -1;
+				modes |= 1 << MODE_SUMMARY;
+				break;
+			case 'k':
+				if (parse_opt_oem_key(optarg) < 0)
+					return -1;
+				opt.flags |= FLAG_QUIET;
+				modes |= 1 << MODE_OEM_KEY;
+				break;
+			case 'e':
+				if (optarg != NULL
+				 && parse_opt_event_log_offset(optarg) < 0)
+					return -1;
+				opt.flags |= FLAG_EVENT_LOG;
+				modes |= 1 << MODE_EVENT_LOG;
+				break;
+			case 'K':
+				opt.flags |= FLAG_PCI_MAP | FLAG_QUIET;
+				modes |= 1 << MODE_PCI_MAP;
+				break;
+			case 'r':
+				opt.flags |= FLAG_REDFISH | FLAG_QUIET;
+				modes |= 1 << MODE_REDFISH;
+				break;
+			case 'i':
+				opt.flags |= FLAG_IPMI | FLAG_QUIET;
+				modes |= 1 << MODE_IPMI;
+				break;
+			case 'G':
+				opt.flags |= FLAG_TREE;
+				modes |= 1 << MODE_TREE;
+				break;
+			case 'J':
+				opt.flags |= FLAG_JSON | FLAG_QUIET;
+				modifiers |= MOD_JSON;
+				break;
+			case 'W':
+				opt.watch = parse_opt_watch(optarg);
+				if (opt.watch == 0)
+					return -1;
+				modes |= 1 << MODE_WATCH;
 				break;
 			case 'u':
 				opt.flags |= FLAG_DUMP;
+				modifiers |= MOD_DUMP;
 				break;
 			case 'S':
 				opt.flags |= FLAG_NO_SYSFS;
@@ -345,6 +1092,10 @@ int parse_command_line(int argc, char * const argv[])
 					fprintf(stdout, "%s\n", opt_type_keyword[i].keyword);
 				opt.flags |= FLAG_LIST;
 				return 0;
+			case 'l':
+				print_opt_field_list(stdout);
+				opt.flags |= FLAG_LIST;
+				return 0;
 			case 'V':
 				opt.flags |= FLAG_VERSION;
 				break;
@@ -364,22 +1115,197 @@ int parse_command_line(int argc, char * const argv[])
 		}
 
 	/* Check for mutually exclusive output format options */
-	if ((opt.string != NULL) + (opt.type != NULL)
-	  + !!(opt.flags & FLAG_DUMP_BIN) + (opt.handle != ~0U) > 1)
+	if ((opt.string != NULL) + (opt.field != NULL) + (opt.type != NULL)
+	  + (opt.handle != ~0U) > 1)
 	{
-		fprintf(stderr, "Options --string, --type, --handle and --dump-bin are mutually exclusive\n");
+		fprintf(stderr, "Options --string, --field, --type and --handle are mutually exclusive\n");
 		return -1;
 	}
 
-	if ((opt.flags & FLAG_FROM_DUMP) && (opt.flags & FLAG_DUMP_BIN))
+	if (check_opt_mode(modes, modifiers) < 0)
+		return -1;
+
+	/* The log area is not part of dump files */
+	if ((opt.flags & FLAG_EVENT_LOG) && (opt.flags & FLAG_FROM_DUMP)
+	 && strcmp(opt.devmem, DEFAULT_MEM_DEV) == 0)
 	{
-		fprintf(stderr, "Options --from-dump and --dump-bin are mutually exclusive\n");
+		fprintf(stderr, "Option --event-log can only be used with --from-dump if --dev-mem is also given\n");
 		return -1;
 	}
 
+	if (opt.fromshm != NULL
+	 && (opt.flags & (FLAG_FROM_DUMP | FLAG_DUMP_BIN)))
+	{
+		fprintf(stderr, "Option --from-shm can't be used with --from-dump, --dump-bin or --store\n");
+		return -1;
+	}
+
+	if ((opt.flags & FLAG_FORMAT) && opt.match_count
+	 && opt.match[0].field->type != opt.format_type)
+	{
+		fprintf(stderr, "Option --match must apply to the type of the fields of the format\n");
+		return -1;
+	}
+
+	if (opt.flags & FLAG_CSV)
+	{
+		if (opt.match_count && opt.match[0].field->type != opt.csv_type)
+		{
+			fprintf(stderr, "Option --match must apply to the type given to --csv\n");
+			return -1;
+		}
+
+		/* Remaining arguments are dump files to read from */
+		opt.files = argv + optind;
+		opt.file_count = argc - optind;
+		if (opt.file_count && (opt.flags & FLAG_FROM_DUMP))
+		{
+			fprintf(stderr, "Option --from-dump can't be used with a list of files\n");
+			return -1;
+		}
+	}
+
 	return 0;
 }
 
+/* Output selection is per request */
+static void parse_query_reset(void)
+{
+	opt.flags &= FLAG_NO_QUIRKS;
+	free(opt.type);
+	opt.type = NULL;
+	opt.string = NULL;
+	opt.field = NULL;
+	opt.handle = ~0U;
+	free(opt.match);
+	opt.match = NULL;
+	opt.match_count = 0;
+	free(opt.format);
+	free(opt.format_buf);
+	opt.format = NULL;
+	opt.format_buf = NULL;
+	opt.format_count = 0;
+	opt.format_type = -1;
+	free(opt.locate);
+	opt.locate = NULL;
+	opt.locate_count = 0;
+	free(opt.oem_key);
+	opt.oem_key = NULL;
+	opt.oem_key_count = 0;
+	opt.summary = 0;
+}
+
+/*
+ * Daemon requests are a single line made of a command, which is the name
+ * of the equivalent long option, and its argument if it takes one. Only
+ * options which display information are accepted. Commands which support
+ * JSON output can be preceded by "json". Return -1 on error, 0 on success.
+ */
+int parse_query(char *line)
+{
+	char *arg;
+	int json = 0;
+
+	line[strcspn(line, "\r\n")] = '\0';
+	if (strncmp(line, "json ", 5) == 0)
+	{
+		json = 1;
+		line += 5;
+	}
+	arg = strchr(line, ' ');
+	if (arg != NULL)
+		*arg++ = '\0';
+
+	parse_query_reset();
+	if (json)
+		opt.flags |= FLAG_JSON | FLAG_QUIET;
+
+	if (strcmp(line, "string") == 0 && arg != NULL)
+	{
+		opt.flags |= FLAG_QUIET;
+		return parse_opt_string(arg);
+	}
+	if (strcmp(line, "oem-string") == 0 && arg != NULL)
+	{
+		opt.flags |= FLAG_QUIET;
+		return parse_opt_oem_string(arg);
+	}
+	if (strcmp(line, "field") == 0 && arg != NULL)
+	{
+		opt.flags |= FLAG_QUIET;
+		return parse_opt_field(arg);
+	}
+	if (strcmp(line, "summary") == 0 && arg != NULL)
+	{
+		opt.summary = parse_opt_summary(arg);
+		return opt.summary == 0 ? -1 : 0;
+	}
+	if (strcmp(line, "tree") == 0 && arg == NULL)
+	{
+		opt.flags |= FLAG_TREE;
+		return 0;
+	}
+	if (strcmp(line, "redfish") == 0 && arg == NULL)
+	{
+		opt.flags |= FLAG_REDFISH | FLAG_QUIET;
+		return 0;
+	}
+	if (strcmp(line, "ipmi") == 0 && arg == NULL)
+	{
+		opt.flags |= FLAG_IPMI | FLAG_QUIET;
+		return 0;
+	}
+	if (json)
+		goto invalid;
+
+	if (strcmp(line, "decode") == 0 && arg == NULL)
+		return 0;
+	if (strcmp(line, "dump") == 0 && arg == NULL)
+	{
+		opt.flags |= FLAG_DUMP;
+		return 0;
+	}
+	if (strcmp(line, "export") == 0 && arg == NULL)
+	{
+		opt.flags |= FLAG_EXPORT | FLAG_QUIET;
+		return 0;
+	}
+	if (strcmp(line, "fingerprint") == 0 && arg == NULL)
+	{
+		opt.flags |= FLAG_FINGERPRINT;
+		return 0;
+	}
+
+	if (arg == NULL)
+		goto invalid;
+
+	if (strcmp(line, "type") == 0)
+	{
+		opt.type = parse_opt_type(NULL, arg);
+		return opt.type == NULL ? -1 : 0;
+	}
+	if (strcmp(line, "handle") == 0)
+	{
+		opt.handle = parse_opt_handle(arg);
+		return opt.handle == ~0U ? -1 : 0;
+	}
+	if (strcmp(line, "format") == 0)
+	{
+		opt.flags |= FLAG_FORMAT | FLAG_QUIET;
+		return parse_opt_format(arg);
+	}
+
+invalid:
+	fprintf(stderr, "Invalid request: %s%s\n", json ? "json " : "", line);
+	fprintf(stderr, "Valid requests are decode, dump, export, fingerprint, "
+		"type TYPE,\nhandle HANDLE, string KEYWORD, oem-string N, "
+		"field TYPE.NAME,\nformat TEMPLATE, summary WHAT, tree, "
+		"redfish and ipmi\n");
+	fprintf(stderr, "Requests string, oem-string, field, summary, tree, "
+		"redfish and ipmi\ncan be preceded by json\n");
+	return -1;
+}
+
 void print_help(void)
 {
 	static const char *help =
@@ -393,12 +1319,42 @@ void print_help(void)
 		"     --list-strings     List available string keywords and exit\n"
 		" -t, --type TYPE        Only display the entries of given type\n"
 		"     --list-types       List available type keywords and exit\n"
+		"     --field TYPE.NAME  Only display the value of the given field\n"
+		"     --list-fields      List available fields and exit\n"
+		"     --match TYPE.NAME=VALUE\n"
+		"                        Only consider entries with the given field value\n"
 		" -H, --handle HANDLE    Only display the entry of given handle\n"
 		" -u, --dump             Do not decode the entries\n"
 		"     --dump-bin FILE    Dump the DMI data to a binary file\n"
+		"     --dump-index       Add an index of the entries to the binary file\n"
 		"     --from-dump FILE   Read the DMI data from a binary file\n"
+		"     --store FILE       Save the DMI data as a record in a dump store\n"
+		"     --diff FILE        Compare the DMI data with a binary file\n"
+		"     --fingerprint      Display a hash of each entry and of the table\n"
 		"     --no-sysfs         Do not attempt to read DMI data from sysfs files\n"
+		"     --jobs N           Decode the entries using N processes\n"
+		"     --csv TYPE [FILE...]\n"
+		"                        Export the entries of given type as CSV\n"
+		"     --export           Display all strings as shell variable assignments\n"
+		"     --format TEMPLATE  Display strings and fields using the given template\n"
+		"     --daemon SOCKET    Answer requests on the given Unix socket\n"
+		"     --replace          Replace the socket of --daemon if it exists\n"
+		"     --publish NAME     Publish the DMI data to shared memory\n"
+		"     --from-shm NAME    Read the DMI data from shared memory\n"
+		"     --watch SECONDS    Display the changes to the DMI data periodically\n"
+		"     --prometheus FILE  Write Prometheus metrics to FILE\n"
+		"     --locate-address ADDR\n"
+		"                        Display the memory device of physical address ADDR\n"
+		"     --summary WHAT     Display a summary of the given hardware\n"
+		"     --tree             Display the physical containment tree\n"
+		"     --pci-map          Display the slots and devices by PCI address\n"
+		"     --json             Display the summary, tree, Redfish or IPMI data in JSON\n"
 		"     --oem-string N     Only display the value of the given OEM string\n"
+		"     --oem-key KEY      Only display the value of the OEM string KEY=VALUE\n"
+		"     --event-log[=OFFSET]\n"
+		"                        Display the system event log records\n"
+		"     --redfish          Display the Redfish host interface parameters\n"
+		"     --ipmi             Display the IPMI device parameters\n"
 		" -V, --version          Display the version and exit\n";
 
 	printf("%s", help);
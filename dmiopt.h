@@ -20,6 +20,7 @@
  */
 
 #include "types.h"
+#include "dmidecode.h"
 
 struct string_keyword
 {
@@ -28,17 +29,69 @@ struct string_keyword
 	u8 offset;
 };
 
+struct match_value
+{
+	const struct dmi_field *field;
+	const char *text;	/* Compared to the decoded value, if !raw */
+	int raw;		/* Compare the field bytes to code */
+	u32 code;
+};
+
+enum format_kind
+{
+	FORMAT_TEXT,		/* Literal text */
+	FORMAT_STRING,		/* String keyword, as with --string */
+	FORMAT_FIELD,		/* Field of the repeated type */
+	FORMAT_OEM,		/* OEM string */
+};
+
+struct format_item
+{
+	enum format_kind kind;
+	const char *text;
+	const struct string_keyword *string;
+	const struct dmi_field *field;
+	unsigned int oem;	/* OEM string number, from 1 */
+};
+
 struct opt
 {
 	const char *devmem;
 	unsigned int flags;
 	u8 *type;
 	const struct string_keyword *string;
+	const struct dmi_field *field;
+	struct match_value *match;
+	unsigned int match_count;
 	char *dumpfile;
+	char *fromfile;
+	char *diff;
 	u32 handle;
+	unsigned int jobs;
+	u8 csv_type;
+	char * const *files;	/* Dump files to export with --csv */
+	int file_count;
+	struct format_item *format;
+	unsigned int format_count;
+	char *format_buf;	/* Literal text of the format items */
+	int format_type;	/* Type of the fields, -1 if none */
+	const char *daemon;	/* Socket path */
+	const char *publish;	/* Shared memory object names */
+	const char *fromshm;
+	unsigned int watch;	/* Interval in seconds, 0 if not watching */
+	const char *prometheus;	/* Metrics file */
+	unsigned long long *locate;	/* Physical addresses */
+	unsigned int locate_count;
+	const char **oem_key;
+	unsigned int oem_key_count;
+	unsigned int event_log_offset;
+	unsigned int summary;	/* Bit mask, see dmi_summary_bit() */
 };
 extern struct opt opt;
 
+extern const struct string_keyword opt_string_keyword[];
+extern const unsigned int opt_string_keyword_count;
+
 #define FLAG_VERSION            (1 << 0)
 #define FLAG_HELP               (1 << 1)
 #define FLAG_DUMP               (1 << 2)
@@ -48,6 +101,23 @@ extern struct opt opt;
 #define FLAG_NO_SYSFS           (1 << 6)
 #define FLAG_NO_QUIRKS          (1 << 7)
 #define FLAG_LIST               (1 << 8)
+#define FLAG_FINGERPRINT        (1 << 9)
+#define FLAG_STORE              (1 << 10)
+#define FLAG_DUMP_INDEX         (1 << 11)
+#define FLAG_CSV                (1 << 12)
+#define FLAG_EXPORT             (1 << 13)
+#define FLAG_FORMAT             (1 << 14)
+#define FLAG_JSON               (1 << 15)
+#define FLAG_REPLACE            (1 << 16)
+#define FLAG_LOCATE             (1 << 17)
+#define FLAG_LOCATE_STDIN       (1 << 18)
+#define FLAG_TREE               (1 << 19)
+#define FLAG_PCI_MAP            (1 << 20)
+#define FLAG_EVENT_LOG          (1 << 21)
+#define FLAG_REDFISH            (1 << 22)
+#define FLAG_IPMI               (1 << 23)
 
 int parse_command_line(int argc, char * const argv[]);
+int parse_query(char *line);
+int parse_address(const char *arg, unsigned long long *addr);
 void print_help(void);
@@ -21,8 +21,38 @@
 
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 #include "dmioutput.h"
 
+/*
+ * While a capture buffer is set, the value of the first attribute is
+ * stored there instead of being printed. This lets the decoding helpers
+ * be reused to retrieve the value of a single field.
+ */
+static char *capture_buf;
+static size_t capture_size;
+static enum {
+	CAPTURE_NONE,
+	CAPTURE_ATTR,
+	CAPTURE_LIST,		/* list items are still being appended */
+	CAPTURE_LIST_END,
+} capture_state;
+
+void pr_capture_start(char *buf, size_t size)
+{
+	capture_buf = buf;
+	capture_size = size;
+	capture_state = CAPTURE_NONE;
+	buf[0] = '\0';
+}
+
+/* Returns 1 if a value was captured, 0 otherwise */
+int pr_capture_end(void)
+{
+	capture_buf = NULL;
+	return capture_state != CAPTURE_NONE;
+}
+
 void pr_comment(const char *format, ...)
 {
 	va_list args;
@@ -64,6 +94,18 @@ void pr_attr(const char *name, const char *format, ...)
 {
 	va_list args;
 
+	if (capture_buf)
+	{
+		if (capture_state == CAPTURE_NONE)
+		{
+			va_start(args, format);
+			vsnprintf(capture_buf, capture_size, format, args);
+			va_end(args);
+			capture_state = CAPTURE_ATTR;
+		}
+		return;
+	}
+
 	printf("\t%s: ", name);
 
 	va_start(args, format);
@@ -76,6 +118,9 @@ void pr_subattr(const char *name, const char *format, ...)
 {
 	va_list args;
 
+	if (capture_buf)
+		return;
+
 	printf("\t\t%s: ", name);
 
 	va_start(args, format);
@@ -88,6 +133,21 @@ void pr_list_start(const char *name, const char *format, ...)
 {
 	va_list args;
 
+	if (capture_buf)
+	{
+		if (capture_state == CAPTURE_NONE)
+		{
+			if (format)
+			{
+				va_start(args, format);
+				vsnprintf(capture_buf, capture_size, format, args);
+				va_end(args);
+			}
+			capture_state = CAPTURE_LIST;
+		}
+		return;
+	}
+
 	printf("\t%s:", name);
 
 	/* format is optional, skip value if not provided */
@@ -106,6 +166,25 @@ void pr_list_item(const char *format, ...)
 {
 	va_list args;
 
+	if (capture_buf)
+	{
+		size_t len = strlen(capture_buf);
+
+		if (capture_state != CAPTURE_LIST)
+			return;
+
+		/* Items are joined in a comma-separated list */
+		if (len && len + 2 < capture_size)
+		{
+			strcpy(capture_buf + len, ", ");
+			len += 2;
+		}
+		va_start(args, format);
+		vsnprintf(capture_buf + len, capture_size - len, format, args);
+		va_end(args);
+		return;
+	}
+
 	printf("\t\t");
 
 	va_start(args, format);
@@ -116,7 +195,25 @@ void pr_list_item(const char *format, ...)
 
 void pr_list_end(void)
 {
-	/* a no-op for text output */
+	if (capture_buf && capture_state == CAPTURE_LIST)
+		capture_state = CAPTURE_LIST_END;
+	/* otherwise a no-op for text output */
+}
+
+/* Quoted and escaped string, for JSON output */
+void pr_json_string(const char *s)
+{
+	putchar('"');
+	for (; *s; s++)
+	{
+		if (*s == '"' || *s == '\\')
+			printf("\\%c", *s);
+		else if ((unsigned char)*s < 0x20)
+			printf("\\u%04X", (unsigned char)*s);
+		else
+			putchar(*s);
+	}
+	putchar('"');
 }
 
 void pr_sep(void)
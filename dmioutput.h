@@ -19,6 +19,8 @@
  *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
  */
 
+#include <stddef.h>
+
 #include "dmidecode.h"
 
 void pr_comment(const char *format, ...);
@@ -31,4 +33,7 @@ void pr_list_start(const char *name, const char *format, ...);
 void pr_list_item(const char *format, ...);
 void pr_list_end(void);
 void pr_sep(void);
+void pr_json_string(const char *s);
 void pr_struct_err(const char *format, ...);
+void pr_capture_start(char *buf, size_t size);
+int pr_capture_end(void);
@@ -0,0 +1,176 @@
+/*
+ * PCI address map
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * The PCI map has one line per bus address found in the system slots
+ * (type 9), including their peer devices, and in the onboard devices
+ * (type 41). Lines are sorted by address and addresses are unique, so
+ * that the output can be searched with a binary search. Fields are
+ * separated by tabs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "types.h"
+#include "dmidecode.h"
+#include "dmipci.h"
+
+struct dmi_pci_entry
+{
+	u32 address;		/* Segment, bus, device/function */
+	u8 source;		/* Index in dmi_pci_sources[] */
+	u16 handle;
+	u8 width;		/* Peers only */
+	const struct dmi_header *h;
+};
+
+static const char * const dmi_pci_sources[] = {
+	"slot",
+	"peer",
+	"onboard",
+};
+
+static int dmi_pci_cmp(const void *a, const void *b)
+{
+	const struct dmi_pci_entry *ea = a, *eb = b;
+
+	if (ea->address != eb->address)
+		return ea->address < eb->address ? -1 : 1;
+	if (ea->source != eb->source)
+		return ea->source < eb->source ? -1 : 1;
+	if (ea->handle != eb->handle)
+		return ea->handle < eb->handle ? -1 : 1;
+	return ea->width < eb->width ? -1 : ea->width > eb->width;
+}
+
+/* Returns 0 if the address is unknown */
+static int dmi_pci_add(struct dmi_pci_entry *e, const u8 *p, u8 source,
+		       const struct dmi_header *h)
+{
+	if (WORD(p) == 0xFFFF && p[2] == 0xFF && p[3] == 0xFF)
+		return 0;
+	e->address = ((u32)WORD(p) << 16) | (p[2] << 8) | p[3];
+	e->source = source;
+	e->handle = h->handle;
+	e->width = source == 1 ? p[4] : 0;
+	e->h = h;
+	return 1;
+}
+
+/* Tabs and new lines would break the columns */
+static void dmi_pci_print_string(const char *s)
+{
+	if (*s == '\0')
+		s = "-";
+	for (; *s; s++)
+		putchar(*s == '\t' || *s == '\n' ? ' ' : *s);
+}
+
+static void dmi_pci_print_field(u8 type, const char *name,
+				const struct dmi_header *h, u16 ver)
+{
+	const struct dmi_field *f = dmi_field_find(type, name);
+	const char *value = NULL;
+	char buf[80];
+
+	if (f != NULL)
+		value = dmi_field_value(f, h, ver, buf, sizeof(buf));
+	putchar('\t');
+	dmi_pci_print_string(value != NULL ? value : "-");
+}
+
+void dmi_pci_map(const struct dmi_index *idx, u16 ver)
+{
+	struct dmi_pci_entry *e;
+	unsigned int count = 0, alloc = 0, i, j;
+
+	/* Each slot has at most 255 peers, count them first */
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+
+		if (h->type == 9)
+			alloc += 1 + (h->length >= 0x13 ? h->data[0x12] : 0);
+		else if (h->type == 41)
+			alloc++;
+	}
+	if ((e = malloc((alloc + 1) * sizeof(*e))) == NULL)
+	{
+		perror("malloc");
+		return;
+	}
+
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+
+		/* 7.10 System Slots */
+		if (h->type == 9 && h->length >= 0x11)
+		{
+			count += dmi_pci_add(&e[count], h->data + 0x0D, 0, h);
+			if (h->length < 0x13
+			 || h->length < 0x13 + h->data[0x12] * 5)
+				continue;
+			for (j = 0; j < h->data[0x12]; j++)
+				count += dmi_pci_add(&e[count],
+						     h->data + 0x13 + 5 * j, 1, h);
+		}
+
+		/* 7.42 Onboard Devices Extended Information */
+		if (h->type == 41 && h->length >= 0x0B)
+			count += dmi_pci_add(&e[count], h->data + 0x07, 2, h);
+	}
+
+	qsort(e, count, sizeof(*e), dmi_pci_cmp);
+
+	for (i = 0; i < count; i++)
+	{
+		const struct dmi_header *h = e[i].h;
+
+		/*
+		 * Keep addresses unique, slots first. Peer lists often include
+		 * the address of the slot itself.
+		 */
+		if (i && e[i - 1].address == e[i].address)
+			continue;
+
+		printf("%04x:%02x:%02x.%x\t%s\t0x%04X",
+		       e[i].address >> 16, (e[i].address >> 8) & 0xFF,
+		       (e[i].address >> 3) & 0x1F, e[i].address & 0x07,
+		       dmi_pci_sources[e[i].source], e[i].handle);
+		if (h->type == 9)
+		{
+			dmi_pci_print_field(9, "Designation", h, ver);
+			dmi_pci_print_field(9, "Type", h, ver);
+			if (e[i].source == 1)
+				printf("\tx%u", e[i].width);
+			else
+				dmi_pci_print_field(9, "Data Bus Width", h, ver);
+			printf("\t-\n");
+		}
+		else
+		{
+			dmi_pci_print_field(41, "Reference Designation", h, ver);
+			dmi_pci_print_field(41, "Type", h, ver);
+			printf("\t-\t%u\n", h->data[0x06]);
+		}
+	}
+
+	free(e);
+}
+
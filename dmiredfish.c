@@ -0,0 +1,209 @@
+/*
+ * Redfish host interface discovery
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * The Redfish export has one record per Redfish over IP protocol record
+ * of the Management Controller Host Interface entries (type 42), along
+ * with the network device of the interface. Records are either shell
+ * variables named REDFISH_<n>_<KEY>, numbered from 1, or JSON objects.
+ * Keys which don't apply to the interface or the protocol record are
+ * omitted.
+ */
+
+#include <stdio.h>
+
+#include "types.h"
+#include "dmidecode.h"
+#include "dmiopt.h"
+#include "dmiexport.h"
+#include "dmiredfish.h"
+
+static void dmi_redfish_id(const char *prefix, const char *key, const u8 *p)
+{
+	char buf[8];
+
+	snprintf(buf, sizeof(buf), "0x%04x", WORD(p));
+	dmi_record_string(prefix, key, buf);
+}
+
+static void dmi_redfish_mac(const char *prefix, const u8 *p)
+{
+	char buf[18];
+
+	snprintf(buf, sizeof(buf), "%02x:%02x:%02x:%02x:%02x:%02x",
+		 p[0], p[1], p[2], p[3], p[4], p[5]);
+	dmi_record_string(prefix, "mac_address", buf);
+}
+
+/* DSP0270: 8.3 Network interface device, as decoded for type 42 */
+static void dmi_redfish_device(const char *prefix, const struct dmi_header *h)
+{
+	const u8 *p = h->data + 0x07;
+	u8 type = h->data[0x06], len = h->data[0x05];
+	char buf[16];
+
+	if (len == 0)
+		return;
+	dmi_record_string(prefix, "device_type", dmi_parse_device_type(type));
+
+	if (type == 0x2 && len >= 5)
+	{
+		dmi_redfish_id(prefix, "vendor_id", p);
+		dmi_redfish_id(prefix, "product_id", p + 0x2);
+	}
+	else if (type == 0x3 && len >= 9)
+	{
+		dmi_redfish_id(prefix, "vendor_id", p);
+		dmi_redfish_id(prefix, "device_id", p + 0x2);
+		dmi_redfish_id(prefix, "subvendor_id", p + 0x4);
+		dmi_redfish_id(prefix, "subdevice_id", p + 0x6);
+	}
+	else if (type == 0x4 && len >= 0x0d)
+	{
+		dmi_redfish_id(prefix, "vendor_id", p + 0x1);
+		dmi_redfish_id(prefix, "product_id", p + 0x3);
+		dmi_redfish_mac(prefix, p + 0x6);
+	}
+	else if (type == 0x5 && len >= 0x14)
+	{
+		dmi_redfish_id(prefix, "vendor_id", p + 0x1);
+		dmi_redfish_id(prefix, "device_id", p + 0x3);
+		dmi_redfish_id(prefix, "subvendor_id", p + 0x5);
+		dmi_redfish_id(prefix, "subdevice_id", p + 0x7);
+		dmi_redfish_mac(prefix, p + 0x9);
+		snprintf(buf, sizeof(buf), "%04x:%02x:%02x.%x", WORD(p + 0xf),
+			 p[0x11], p[0x12] >> 3, p[0x12] & 0x7);
+		dmi_record_string(prefix, "bus_address", buf);
+	}
+}
+
+/*
+ * DSP0270: 8.4.1 Address and mask, for static and AutoConf assignment
+ * types only, as when decoding
+ */
+static void dmi_redfish_address(const char *prefix, const char *name,
+				const u8 *p, u8 assignment)
+{
+	char key[32], buf[64];
+
+	snprintf(key, sizeof(key), "%s_address_format", name);
+	dmi_record_string(prefix, key, dmi_address_type(p[0]));
+	if (assignment != 0x1 && assignment != 0x3)
+		return;
+	snprintf(key, sizeof(key), "%s_address", name);
+	dmi_record_string(prefix, key, dmi_address_decode(p + 1, buf, p[0]));
+	snprintf(key, sizeof(key), "%s_mask", name);
+	dmi_record_string(prefix, key, dmi_address_decode(p + 17, buf, p[0]));
+}
+
+/* DSP0270: 8.4.1 Redfish over IP protocol record data */
+static void dmi_redfish_record(unsigned int n, const struct dmi_header *h,
+			       const u8 *rdata, u8 rlen)
+{
+	char prefix[24], buf[256];
+	int only0xFF = 1, only0x00 = 1, i;
+
+	snprintf(prefix, sizeof(prefix), "REDFISH_%u_", n);
+	if (opt.flags & FLAG_JSON)
+	{
+		printf("%s\n  {", n > 1 ? "," : "");
+		dmi_record_begin(4);
+	}
+	dmi_record_handle(prefix, "handle", h->handle);
+	dmi_record_string(prefix, "interface_type", "Network");
+	dmi_redfish_device(prefix, h);
+
+	/* Always little-endian, see dmi_parse_protocol_record() */
+	for (i = 0; i < 16; i++)
+	{
+		if (rdata[i] != 0x00) only0x00 = 0;
+		if (rdata[i] != 0xFF) only0xFF = 0;
+	}
+	if (only0x00 || only0xFF)
+		buf[0] = '\0';
+	else
+		snprintf(buf, sizeof(buf),
+			 "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+			 rdata[3], rdata[2], rdata[1], rdata[0], rdata[5],
+			 rdata[4], rdata[7], rdata[6], rdata[8], rdata[9],
+			 rdata[10], rdata[11], rdata[12], rdata[13], rdata[14],
+			 rdata[15]);
+	dmi_record_string(prefix, "service_uuid", buf);
+
+	dmi_record_string(prefix, "host_ip_assignment_type",
+			   dmi_protocol_assignment_type(rdata[16]));
+	dmi_redfish_address(prefix, "host_ip", rdata + 17, rdata[16]);
+	dmi_record_string(prefix, "service_ip_discovery_type",
+			   dmi_protocol_assignment_type(rdata[50]));
+	dmi_redfish_address(prefix, "service_ip", rdata + 51, rdata[50]);
+	if (rdata[50] == 0x1 || rdata[50] == 0x3)
+	{
+		dmi_record_number(prefix, "service_port", WORD(rdata + 84));
+		dmi_record_number(prefix, "service_vlan", DWORD(rdata + 86));
+	}
+	if (rdata[90] + 91 <= rlen)
+	{
+		snprintf(buf, sizeof(buf), "%.*s", rdata[90],
+			 (const char *)rdata + 91);
+		dmi_record_string(prefix, "service_hostname", buf);
+	}
+
+	if (opt.flags & FLAG_JSON)
+		printf("\n  }");
+}
+
+void dmi_redfish(const struct dmi_index *idx, u16 ver)
+{
+	unsigned int count = 0, i, j;
+
+	if (opt.flags & FLAG_JSON)
+		printf("[");
+
+	/* Same bounds checks as dmi_parse_controller_structure() */
+	for (i = 0; ver >= 0x0302 && i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+		const u8 *rec;
+		u32 total;
+		u8 records;
+
+		if (h->type != 42 || h->length < 0x0B || h->data[0x04] != 0x40)
+			continue;
+		total = 0x06 + h->data[0x05];
+		if (total + 1 > h->length)
+			continue;
+		records = h->data[total];
+		rec = h->data + total + 1;
+		total++;
+
+		/* Protocol records have a type and a length byte */
+		for (j = 0; j < records; j++, rec += rec[1] + 2)
+		{
+			if (total + 2 > h->length || total + 2 + rec[1] > h->length)
+				break;
+			total += 2 + rec[1];
+			/* DSP0270: 8.4 Redfish over IP */
+			if (rec[0] == 0x4 && rec[1] >= 91)
+				dmi_redfish_record(++count, h, rec + 2, rec[1]);
+		}
+	}
+
+	if (opt.flags & FLAG_JSON)
+		printf(count ? "\n]\n" : "]\n");
+	else
+		printf("REDFISH_COUNT='%u'\n", count);
+}
@@ -0,0 +1,264 @@
+/*
+ * Publication of the DMI table in shared memory
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+#include <sys/types.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "types.h"
+#include "dmidecode.h"
+#include "dmishm.h"
+
+#define SHM_READ_RETRIES	1000
+
+/* Shared memory object names must start with a slash */
+static int dmi_shm_open(const char *name, int flags, mode_t mode)
+{
+	char path[256];
+	int fd;
+
+	snprintf(path, sizeof(path), "%s%s", name[0] == '/' ? "" : "/", name);
+	if ((fd = shm_open(path, flags, mode)) == -1)
+	{
+		fprintf(stderr, "%s: ", path);
+		perror("shm_open");
+	}
+	return fd;
+}
+
+int dmi_shm_publish(const char *name, u8 *table, u32 len, u16 num, u16 ver,
+		    int stop_at_eot)
+{
+	struct dmi_index idx = { NULL, 0, NULL };
+	struct dmi_shm_header *hdr;
+	struct dmi_shm_entry *entry;
+	u32 *order;
+	u32 size, table_offset, entry_offset, order_offset, seq, i;
+	struct stat st;
+	void *map = MAP_FAILED;
+	int fd, ret = -1;
+
+	if (dmi_index_build(&idx, table, len, num, stop_at_eot) != 0)
+		return -1;
+
+	table_offset = sizeof(*hdr);
+	entry_offset = (table_offset + len + 7) & ~7U;
+	order_offset = entry_offset + idx.count * sizeof(*entry);
+	size = order_offset + idx.count * sizeof(*order);
+
+	if ((fd = dmi_shm_open(name, O_RDWR | O_CREAT, 0644)) == -1)
+		goto out;
+
+	if (fstat(fd, &st) == -1)
+	{
+		perror(name);
+		goto out;
+	}
+
+	/*
+	 * Whoever created the object can still write to it, and feed
+	 * forged tables to the readers
+	 */
+	if (st.st_uid != geteuid())
+	{
+		fprintf(stderr, "%s: Shared memory object owned by another user, "
+			"refusing to publish\n", name);
+		goto out;
+	}
+
+	/* Readers are typically not privileged, don't depend on umask */
+	if (fchmod(fd, 0644) == -1 || flock(fd, LOCK_EX) == -1
+	 || fstat(fd, &st) == -1)
+	{
+		perror(name);
+		goto out;
+	}
+
+	/* Never shrink the segment, existing mappings must stay valid */
+	if (st.st_size < (off_t)size && ftruncate(fd, size) == -1)
+	{
+		perror("ftruncate");
+		goto out;
+	}
+
+	map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED)
+	{
+		perror("mmap");
+		goto out;
+	}
+	hdr = map;
+
+	/* Start a new generation, or the first one for a new segment */
+	if (memcmp(hdr->magic, SHM_MAGIC, 8) == 0 && hdr->version == SHM_VERSION)
+	{
+		seq = hdr->sequence | 1;
+		hdr->generation++;
+	}
+	else
+	{
+		seq = 1;
+		hdr->generation = 1;
+	}
+	hdr->sequence = seq;
+	__sync_synchronize();
+
+	memcpy(hdr->magic, SHM_MAGIC, 8);
+	hdr->version = SHM_VERSION;
+	hdr->size = size;
+	hdr->smbios_version = ver;
+	hdr->flags = stop_at_eot ? SHM_FLAG_STOP_AT_EOT : 0;
+	hdr->num = num;
+	hdr->table_offset = table_offset;
+	hdr->table_len = len;
+	hdr->count = idx.count;
+	hdr->entry_offset = entry_offset;
+	hdr->order_offset = order_offset;
+	memcpy((u8 *)map + table_offset, table, len);
+
+	entry = (struct dmi_shm_entry *)((u8 *)map + entry_offset);
+	order = (u32 *)((u8 *)map + order_offset);
+	for (i = 0; i < idx.count; i++)
+	{
+		entry[i].offset = idx.entry[i].h.data - table;
+		entry[i].type = idx.entry[i].h.type;
+		entry[i].length = idx.entry[i].h.length;
+		entry[i].handle = idx.entry[i].h.handle;
+		entry[i].size = idx.entry[i].size;
+		order[i] = idx.by_handle[i] - idx.entry;
+	}
+
+	__sync_synchronize();
+	hdr->sequence = seq + 1;
+	ret = 0;
+
+out:
+	if (map != MAP_FAILED)
+		munmap(map, size);
+	if (fd != -1)
+		close(fd);
+	dmi_index_free(&idx);
+	return ret;
+}
+
+/*
+ * Copy the table out of the segment, as a reader would. Returns NULL if
+ * the segment can't be read or no consistent copy could be made.
+ */
+u8 *dmi_shm_read(const char *name, u32 *len, u16 *num, u16 *ver,
+		 int *stop_at_eot)
+{
+	const struct dmi_shm_header *hdr;
+	struct stat st;
+	void *map = MAP_FAILED;
+	size_t map_size = 0;
+	u8 *table = NULL;
+	u32 seq;
+	int fd, i;
+
+	if ((fd = dmi_shm_open(name, O_RDONLY, 0)) == -1)
+		return NULL;
+
+	for (i = 0; i < SHM_READ_RETRIES; i++)
+	{
+		/* Map again if the segment grew */
+		if (map == MAP_FAILED || ((const struct dmi_shm_header *)map)->size > map_size)
+		{
+			if (map != MAP_FAILED)
+				munmap(map, map_size);
+			if (fstat(fd, &st) == -1)
+			{
+				perror(name);
+				break;
+			}
+			if ((size_t)st.st_size < sizeof(*hdr))
+			{
+				fprintf(stderr, "%s: Segment too small\n", name);
+				break;
+			}
+			map_size = st.st_size;
+			map = mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0);
+			if (map == MAP_FAILED)
+			{
+				perror("mmap");
+				break;
+			}
+		}
+		hdr = map;
+
+		seq = hdr->sequence;
+		__sync_synchronize();
+		if (seq & 1)
+		{
+			sched_yield();
+			continue;
+		}
+
+		if (memcmp(hdr->magic, SHM_MAGIC, 8) != 0
+		 || hdr->version != SHM_VERSION)
+		{
+			fprintf(stderr, "%s: Unsupported segment\n", name);
+			break;
+		}
+		if (hdr->size > map_size)
+			continue;
+		if (hdr->table_offset > hdr->size
+		 || hdr->table_len > hdr->size - hdr->table_offset)
+		{
+			fprintf(stderr, "%s: Corrupted segment\n", name);
+			break;
+		}
+
+		free(table);
+		if ((table = malloc(hdr->table_len ? hdr->table_len : 1)) == NULL)
+		{
+			perror("malloc");
+			break;
+		}
+		memcpy(table, (const u8 *)map + hdr->table_offset,
+		       hdr->table_len);
+		*len = hdr->table_len;
+		*num = hdr->num;
+		*ver = hdr->smbios_version;
+		*stop_at_eot = !!(hdr->flags & SHM_FLAG_STOP_AT_EOT);
+
+		/* The copy is only valid if no update happened meanwhile */
+		__sync_synchronize();
+		if (hdr->sequence == seq)
+			goto out;
+	}
+
+	if (i == SHM_READ_RETRIES)
+		fprintf(stderr, "%s: Segment kept changing\n", name);
+	free(table);
+	table = NULL;
+
+out:
+	if (map != MAP_FAILED)
+		munmap(map, map_size);
+	close(fd);
+	return table;
+}
@@ -0,0 +1,75 @@
+/*
+ * Publication of the DMI table in shared memory
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * The segment starts with the header below, followed by the table, the
+ * structure entries and the handle order. All values are in the native
+ * byte order, as the segment is only shared between processes of the
+ * same host. Offsets are from the start of the segment.
+ *
+ * The segment is updated in place, under a sequence lock: the writer
+ * makes the sequence odd before changing anything else, and even again
+ * when done. Readers read the sequence, skip the segment (or wait) if
+ * it is odd, read what they need, then check that the sequence didn't
+ * change, else they start over. The segment never shrinks, so existing
+ * mappings stay valid, but it may grow, in which case readers have to
+ * map it again according to the size field.
+ */
+
+#ifndef DMISHM_H
+#define DMISHM_H
+
+#include "types.h"
+
+#define SHM_MAGIC		"_DMISHM_"
+#define SHM_VERSION		1
+
+struct dmi_shm_header
+{
+	char magic[8];
+	u32 version;		/* Format version */
+	u32 sequence;		/* Odd while the segment is being updated */
+	u32 generation;		/* Incremented on each publication */
+	u32 size;		/* Used size of the segment */
+	u32 smbios_version;	/* Major and minor */
+	u32 flags;		/* SHM_FLAG_* */
+	u32 num;		/* Number of structures announced, 0 if none */
+	u32 table_offset;
+	u32 table_len;
+	u32 count;		/* Number of structures */
+	u32 entry_offset;	/* Structure entries, in table order */
+	u32 order_offset;	/* Entry numbers, sorted by handle */
+	u32 reserved[2];
+};
+
+#define SHM_FLAG_STOP_AT_EOT	(1 << 0)	/* Table ends at type 127 */
+
+struct dmi_shm_entry
+{
+	u32 offset;		/* Of the structure, from the table start */
+	u8 type;
+	u8 length;
+	u16 handle;
+	u32 size;		/* Including strings and terminator */
+};
+
+int dmi_shm_publish(const char *name, u8 *table, u32 len, u16 num, u16 ver,
+		    int stop_at_eot);
+u8 *dmi_shm_read(const char *name, u32 *len, u16 *num, u16 *ver,
+		 int *stop_at_eot);
+
+#endif
@@ -0,0 +1,393 @@
+/*
+ * Content-addressed storage of DMI table dumps
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * A store is a directory holding one record file per dump, and an
+ * "objects" subdirectory holding the structures. Each structure is
+ * saved once, in a file named after the hash of its contents, so
+ * structures which are identical across dumps share the same file.
+ *
+ * Record format (all values are little-endian):
+ *   0x00  8 bytes   Magic "DMISTORE"
+ *   0x08  DWORD     Format version (1)
+ *   0x0C  DWORD     Entry point length
+ *   0x10  DWORD     Table length
+ *   0x14  DWORD     Number of objects
+ *   0x18  8 bytes   Reserved (0)
+ *   0x20  32 bytes  Entry point, as written by --dump-bin
+ *   0x40  QWORD[]   Object hashes, in table order
+ *
+ * The objects are the structures (formatted area and strings) in table
+ * order, followed by whatever trails the last structure, if anything.
+ * Concatenated, they give back the exact table.
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "types.h"
+#include "util.h"
+#include "dmiopt.h"
+#include "dmioutput.h"
+#include "dmistore.h"
+
+#define STORE_VERSION		1
+#define STORE_HEADER_LEN	0x40
+
+/*
+ * Path of the objects directory (depth 0), of the subdirectory of an
+ * object (depth 1) or of an object (depth 2). Objects are spread over 256
+ * subdirectories.
+ */
+static char *dmi_store_path(const char *record, unsigned long long id,
+			    int depth)
+{
+	const char *slash = strrchr(record, '/');
+	int dir_len = slash ? (int)(slash - record) + 1 : 0;
+	size_t size = dir_len + sizeof("objects/XX/") + 14;
+	char *path;
+
+	if ((path = malloc(size)) == NULL)
+	{
+		perror("malloc");
+		return NULL;
+	}
+
+	if (depth == 0)
+		snprintf(path, size, "%.*sobjects", dir_len, record);
+	else if (depth == 1)
+		snprintf(path, size, "%.*sobjects/%02X", dir_len, record,
+			 (unsigned int)(id >> 56));
+	else
+		snprintf(path, size, "%.*sobjects/%02X/%014llX", dir_len,
+			 record, (unsigned int)(id >> 56),
+			 id & 0x00FFFFFFFFFFFFFFULL);
+	return path;
+}
+
+static int dmi_store_mkdir(const char *path)
+{
+	if (mkdir(path, 0777) == -1 && errno != EEXIST)
+	{
+		fprintf(stderr, "%s: ", path);
+		perror("mkdir");
+		return -1;
+	}
+	return 0;
+}
+
+static int dmi_store_write_file(const char *path, const u8 *data, size_t len,
+				int flags)
+{
+	int fd;
+
+	if ((fd = open(path, O_WRONLY | O_CREAT | flags, 0666)) == -1)
+	{
+		fprintf(stderr, "%s: ", path);
+		perror("open");
+		return -1;
+	}
+
+	while (len)
+	{
+		ssize_t r = write(fd, data, len);
+
+		if (r == -1)
+		{
+			if (errno == EINTR)
+				continue;
+			fprintf(stderr, "%s: ", path);
+			perror("write");
+			close(fd);
+			return -1;
+		}
+		data += r;
+		len -= r;
+	}
+
+	if (close(fd) == -1)
+	{
+		fprintf(stderr, "%s: ", path);
+		perror("close");
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Save one object, unless it is already there. Returns 1 if the object
+ * was added, 0 if it was already present, -1 on error.
+ */
+static int dmi_store_object(const char *record, unsigned long long id,
+			    const u8 *data, size_t len)
+{
+	char *path, *tmp = NULL;
+	struct stat st;
+	int ret = -1;
+
+	if ((path = dmi_store_path(record, id, 2)) == NULL)
+		return -1;
+
+	if (stat(path, &st) == 0)
+	{
+		size_t size = len;
+		u8 *old = read_file(0, &size, path);
+
+		/* Extremely unlikely, but better safe than sorry */
+		if (old != NULL && (size != len || (size_t)st.st_size != len
+				 || memcmp(old, data, len) != 0))
+			fprintf(stderr, "%s: Hash collision, sorry.\n", path);
+		else if (old != NULL)
+			ret = 0;
+		free(old);
+		goto out;
+	}
+
+	/* Write to a temporary file first, so that readers never see a
+	   partial object */
+	tmp = dmi_store_path(record, id, 1);
+	if (tmp == NULL || dmi_store_mkdir(tmp) != 0)
+		goto out;
+	free(tmp);
+	if ((tmp = malloc(strlen(path) + 16)) == NULL)
+	{
+		perror("malloc");
+		goto out;
+	}
+	sprintf(tmp, "%s.%d", path, (int)getpid());
+
+	if (dmi_store_write_file(tmp, data, len, O_TRUNC) != 0)
+		goto out;
+	if (rename(tmp, path) == -1)
+	{
+		fprintf(stderr, "%s: ", path);
+		perror("rename");
+		unlink(tmp);
+		goto out;
+	}
+	ret = 1;
+
+out:
+	free(tmp);
+	free(path);
+	return ret;
+}
+
+/* Length of the structure at the start of buf, or 0 if there is none */
+static u32 dmi_store_structure_len(const u8 *buf, u32 len)
+{
+	u32 i;
+
+	if (len < 4 || buf[1] < 4 || buf[1] > len)
+		return 0;
+
+	for (i = buf[1]; i + 1 < len; i++)
+		if (buf[i] == 0 && buf[i + 1] == 0)
+			return i + 2;
+	return 0;
+}
+
+static void dmi_store_put_dword(u8 *p, u32 v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+}
+
+int dmi_store_write(const char *filename, const u8 *ep, u32 ep_len,
+		    const u8 *table, u32 table_len)
+{
+	u8 *record;
+	size_t size = STORE_HEADER_LEN, alloc = STORE_HEADER_LEN + 4096;
+	u32 offset = 0, count = 0, added = 0, added_bytes = 0;
+	char *objects;
+	int ret = -1;
+
+	/* Like --dump-bin, refuse to overwrite an existing file */
+	if (access(filename, F_OK) == 0)
+	{
+		fprintf(stderr, "%s: File exists\n", filename);
+		return -1;
+	}
+
+	if ((record = malloc(alloc)) == NULL)
+	{
+		perror("malloc");
+		return -1;
+	}
+
+	/* Create the objects directory next to the record */
+	objects = dmi_store_path(filename, 0, 0);
+	if (objects == NULL || dmi_store_mkdir(objects) != 0)
+		goto out;
+
+	while (offset < table_len)
+	{
+		u32 len = dmi_store_structure_len(table + offset,
+						  table_len - offset);
+		unsigned long long id;
+		int r;
+		int i;
+
+		/* Anything after the last structure goes in a single object */
+		if (len == 0)
+			len = table_len - offset;
+
+		if (size == alloc)
+		{
+			u8 *p = realloc(record, alloc * 2);
+
+			if (p == NULL)
+			{
+				perror("realloc");
+				goto out;
+			}
+			record = p;
+			alloc *= 2;
+		}
+
+		id = hash64(table + offset, len, HASH64_INIT);
+		r = dmi_store_object(filename, id, table + offset, len);
+		if (r < 0)
+			goto out;
+		if (r > 0)
+		{
+			added++;
+			added_bytes += len;
+		}
+
+		for (i = 0; i < 8; i++)
+			record[size + i] = id >> (8 * i);
+		size += 8;
+		offset += len;
+		count++;
+	}
+
+	memset(record, 0, STORE_HEADER_LEN);
+	memcpy(record, STORE_MAGIC, 8);
+	dmi_store_put_dword(record + 0x08, STORE_VERSION);
+	dmi_store_put_dword(record + 0x0C, ep_len);
+	dmi_store_put_dword(record + 0x10, table_len);
+	dmi_store_put_dword(record + 0x14, count);
+	memcpy(record + 0x20, ep, ep_len > 32 ? 32 : ep_len);
+
+	if (!(opt.flags & FLAG_QUIET))
+		pr_comment("Storing %u objects in %s, %u new (%u bytes).",
+			   count, filename, added, added_bytes);
+	ret = dmi_store_write_file(filename, record, size, O_EXCL);
+
+out:
+	free(objects);
+	free(record);
+	return ret;
+}
+
+/*
+ * Rebuild the dump image (entry point at offset 0, table at offset 32)
+ * from a record and its objects.
+ */
+u8 *dmi_store_read(const char *filename, size_t *image_len)
+{
+	u8 *record, *image = NULL;
+	size_t size = STORE_HEADER_LEN;
+	u32 ep_len, table_len, count, offset = 0, i;
+
+	if ((record = read_file(0, &size, filename)) == NULL)
+		return NULL;
+	if (size < STORE_HEADER_LEN || memcmp(record, STORE_MAGIC, 8) != 0
+	 || DWORD(record + 0x08) != STORE_VERSION)
+	{
+		fprintf(stderr, "%s: Unsupported store record\n", filename);
+		goto err;
+	}
+
+	ep_len = DWORD(record + 0x0C);
+	table_len = DWORD(record + 0x10);
+	count = DWORD(record + 0x14);
+	if (ep_len > 32 || count > table_len)
+	{
+		fprintf(stderr, "%s: Corrupted store record\n", filename);
+		goto err;
+	}
+
+	if ((image = calloc(1, 32 + (size_t)table_len)) == NULL)
+	{
+		perror("calloc");
+		goto err;
+	}
+	memcpy(image, record + 0x20, ep_len);
+
+	free(record);
+	record = NULL;
+	size = (size_t)count * 8;
+	if (count && (record = read_file(STORE_HEADER_LEN, &size, filename)) == NULL)
+		goto err;
+	if (size != (size_t)count * 8)
+	{
+		fprintf(stderr, "%s: Truncated store record\n", filename);
+		goto err;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		unsigned long long id = ((unsigned long long)DWORD(record + 8 * i + 4) << 32)
+					| DWORD(record + 8 * i);
+		char *path = dmi_store_path(filename, id, 2);
+		size_t len = table_len - offset;
+		u8 *data;
+
+		if (path == NULL)
+			goto err;
+		data = len ? read_file(0, &len, path) : NULL;
+		if (data == NULL || hash64(data, len, HASH64_INIT) != id)
+		{
+			if (data != NULL || len == 0)
+				fprintf(stderr, "%s: Corrupted object\n", path);
+			else if (access(path, F_OK) != 0)
+				fprintf(stderr, "%s: Missing object\n", path);
+			free(data);
+			free(path);
+			goto err;
+		}
+		memcpy(image + 32 + offset, data, len);
+		offset += len;
+		free(data);
+		free(path);
+	}
+
+	if (offset != table_len)
+	{
+		fprintf(stderr, "%s: Table length mismatch\n", filename);
+		goto err;
+	}
+
+	free(record);
+	*image_len = 32 + (size_t)table_len;
+	return image;
+
+err:
+	free(record);
+	free(image);
+	return NULL;
+}
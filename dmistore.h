@@ -0,0 +1,26 @@
+/*
+ * Content-addressed storage of DMI table dumps
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+#include "types.h"
+
+#define STORE_MAGIC	"DMISTORE"
+
+int dmi_store_write(const char *filename, const u8 *ep, u32 ep_len,
+		    const u8 *table, u32 table_len);
+u8 *dmi_store_read(const char *filename, size_t *image_len);
@@ -0,0 +1,833 @@
+/*
+ * Hardware summaries
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * A summary aggregates the raw fields of all the entries of a few types in
+ * a single pass over the table, and displays the totals either as text,
+ * in the same layout as the decoded entries, or as JSON. All summaries
+ * are displayed through the sum_*() functions below, so that both output
+ * formats stay in sync.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "util.h"
+#include "dmidecode.h"
+#include "dmiopt.h"
+#include "dmioutput.h"
+#include "dmilocate.h"
+#include "dmisummary.h"
+
+/*
+ * Output
+ */
+
+static int sum_first;		/* No member was displayed yet (JSON) */
+
+static void sum_json_key(const char *key, int depth)
+{
+	printf("%s\n%*s", sum_first ? "" : ",", 2 * depth, "");
+	if (key != NULL)
+	{
+		pr_json_string(key);
+		printf(": ");
+	}
+	sum_first = 0;
+}
+
+static void sum_begin(const char *key, const char *title)
+{
+	if (opt.flags & FLAG_JSON)
+	{
+		sum_json_key(key, 1);
+		printf("{");
+		sum_first = 1;
+	}
+	else
+		pr_handle_name("%s", title);
+}
+
+static void sum_end(void)
+{
+	if (opt.flags & FLAG_JSON)
+	{
+		printf("\n  }");
+		sum_first = 0;
+	}
+	else
+		pr_sep();
+}
+
+static void sum_number(const char *key, const char *title,
+		       unsigned long long n)
+{
+	if (opt.flags & FLAG_JSON)
+	{
+		sum_json_key(key, 2);
+		printf("%llu", n);
+	}
+	else
+		pr_attr(title, "%llu", n);
+}
+
+/* JSON keys of sizes end with _bytes */
+static void sum_size(const char *key, const char *title,
+		     unsigned long long bytes)
+{
+	u64 code;
+
+	if (opt.flags & FLAG_JSON)
+	{
+		sum_json_key(key, 2);
+		printf("%llu", bytes);
+		return;
+	}
+
+	if (bytes == 0)
+	{
+		pr_attr(title, "None");
+		return;
+	}
+	code.l = bytes;
+	code.h = bytes >> 32;
+	dmi_print_memory_size(title, code, 0);
+}
+
+/* A list of strings (JSON array) */
+static void sum_list_begin(const char *key, const char *title)
+{
+	if (opt.flags & FLAG_JSON)
+	{
+		sum_json_key(key, 2);
+		printf("[");
+		sum_first = 1;
+	}
+	else
+		pr_list_start(title, NULL);
+}
+
+static void sum_list_item(const char *s)
+{
+	if (opt.flags & FLAG_JSON)
+	{
+		sum_json_key(NULL, 3);
+		pr_json_string(s);
+	}
+	else
+		pr_list_item("%s", s);
+}
+
+static void sum_list_end(int empty)
+{
+	if (opt.flags & FLAG_JSON)
+	{
+		printf(empty ? "]" : "\n    ]");
+		sum_first = 0;
+	}
+	else
+		pr_list_end();
+}
+
+/* Value of a field, as displayed when decoding */
+static const char *sum_field(u8 type, const char *name,
+			     const struct dmi_header *h, u16 ver,
+			     char *buf, size_t size)
+{
+	const struct dmi_field *f = dmi_field_find(type, name);
+	const char *value = NULL;
+
+	if (f != NULL)
+		value = dmi_field_value(f, h, ver, buf, size);
+	return value != NULL ? value : "Unknown";
+}
+
+/*
+ * Tallies count how many entries share each distinct value
+ */
+
+struct sum_tally
+{
+	struct
+	{
+		char *name;
+		unsigned int count;
+	} *item;
+	unsigned int count;
+};
+
+static void sum_tally_add(struct sum_tally *t, const char *name)
+{
+	unsigned int i;
+	void *p;
+
+	for (i = 0; i < t->count; i++)
+	{
+		if (strcmp(t->item[i].name, name) == 0)
+		{
+			t->item[i].count++;
+			return;
+		}
+	}
+
+	p = realloc(t->item, (t->count + 1) * sizeof(*t->item));
+	if (p == NULL)
+	{
+		perror("realloc");
+		return;
+	}
+	t->item = p;
+	if ((t->item[t->count].name = strdup(name)) == NULL)
+	{
+		perror("strdup");
+		return;
+	}
+	t->item[t->count].count = 1;
+	t->count++;
+}
+
+static void sum_tally_free(struct sum_tally *t)
+{
+	unsigned int i;
+
+	for (i = 0; i < t->count; i++)
+		free(t->item[i].name);
+	free(t->item);
+}
+
+/* Displayed as "name (count)" items, or as a JSON object */
+static void sum_tally(const char *key, const char *title,
+		      const struct sum_tally *t)
+{
+	unsigned int i;
+
+	if (opt.flags & FLAG_JSON)
+	{
+		sum_json_key(key, 2);
+		printf("{");
+		sum_first = 1;
+		for (i = 0; i < t->count; i++)
+		{
+			sum_json_key(t->item[i].name, 3);
+			printf("%u", t->item[i].count);
+		}
+		printf(t->count ? "\n    }" : "}");
+		sum_first = 0;
+		return;
+	}
+
+	if (t->count == 0)
+		return;
+	pr_list_start(title, NULL);
+	for (i = 0; i < t->count; i++)
+		pr_list_item("%s (%u)", t->item[i].name, t->item[i].count);
+	pr_list_end();
+}
+
+/*
+ * Memory
+ */
+
+static unsigned long long sum_qword(const u8 *p)
+{
+	return ((unsigned long long)DWORD(p + 4) << 32) | DWORD(p);
+}
+
+/* 7.17 Maximum capacity of a physical memory array, in bytes */
+static unsigned long long sum_memory_array_capacity(const struct dmi_header *h)
+{
+	if (h->length < 0x0F)
+		return 0;
+	if (DWORD(h->data + 0x07) == 0x80000000)
+		return h->length >= 0x17 ? sum_qword(h->data + 0x0F) : 0;
+	return (unsigned long long)DWORD(h->data + 0x07) << 10;
+}
+
+/* 7.20 Size of a mapped address range, in bytes */
+static unsigned long long sum_mapped_size(const struct dmi_header *h)
+{
+	unsigned long long start, end;
+
+	if (h->length < 0x0F)
+		return 0;
+	if (h->length >= 0x1F && DWORD(h->data + 0x04) == 0xFFFFFFFF)
+	{
+		start = sum_qword(h->data + 0x0F);
+		end = sum_qword(h->data + 0x17);
+	}
+	else
+	{
+		start = (unsigned long long)DWORD(h->data + 0x04) << 10;
+		end = ((unsigned long long)DWORD(h->data + 0x08) << 10) + 0x3FF;
+	}
+	return end >= start ? end - start + 1 : 0;
+}
+
+/* 7.18 Configured speed of a memory device if known, else its speed */
+static u32 sum_memory_device_speed(const struct dmi_header *h)
+{
+	u32 speed = 0;
+
+	if (h->length >= 0x22)
+	{
+		speed = WORD(h->data + 0x20);
+		if (speed == 0xFFFF)
+			speed = h->length >= 0x5C ? DWORD(h->data + 0x58) : 0;
+	}
+	if (speed == 0 && h->length >= 0x17)
+	{
+		speed = WORD(h->data + 0x15);
+		if (speed == 0xFFFF)
+			speed = h->length >= 0x5C ? DWORD(h->data + 0x54) : 0;
+	}
+	return speed;
+}
+
+static void sum_warning(const struct sum_tally *t, const char *what,
+			int *warnings)
+{
+	char buf[64];
+
+	if (t->count < 2)
+		return;
+	if (*warnings == 0)
+		sum_list_begin("warnings", "Warnings");
+	snprintf(buf, sizeof(buf), "Mixed %s", what);
+	sum_list_item(buf);
+	(*warnings)++;
+}
+
+static void sum_memory_channels(const struct dmi_index *idx)
+{
+	unsigned int i, j, n = 0;
+	char buf[64];
+
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+		unsigned int devices, populated = 0;
+
+		/* 7.38 Memory Channel */
+		if (h->type != 37 || h->length < 0x07)
+			continue;
+
+		devices = h->data[0x06];
+		if (h->length < 0x07 + 3 * devices)
+			devices = (h->length - 0x07) / 3;
+		for (j = 0; j < devices; j++)
+		{
+			const struct dmi_index_entry *d;
+
+			d = dmi_index_find(idx, WORD(h->data + 0x08 + 3 * j));
+			if (d != NULL && d->h.type == 17
+			 && dmi_memory_device_size_kb(&d->h) != 0)
+				populated++;
+		}
+
+		if (n++ == 0)
+		{
+			if (opt.flags & FLAG_JSON)
+			{
+				sum_json_key("channels", 2);
+				printf("[");
+				sum_first = 1;
+			}
+			else
+				pr_list_start("Channels", NULL);
+		}
+		if (opt.flags & FLAG_JSON)
+		{
+			sum_json_key(NULL, 3);
+			printf("{ \"handle\": %u, \"devices\": %u, \"populated\": %u }",
+			       h->handle, devices, populated);
+		}
+		else
+		{
+			snprintf(buf, sizeof(buf),
+				 "0x%04X: %u of %u devices populated",
+				 h->handle, populated, devices);
+			pr_list_item("%s", buf);
+		}
+	}
+	if (n)
+		sum_list_end(0);
+}
+
+static void dmi_summary_memory(const struct dmi_index *idx, u16 ver)
+{
+	struct sum_tally ecc = { NULL, 0 }, types = { NULL, 0 };
+	struct sum_tally speeds = { NULL, 0 }, vendors = { NULL, 0 };
+	struct sum_tally ranks = { NULL, 0 }, sizes = { NULL, 0 };
+	unsigned long long capacity = 0, installed = 0, mapped = 0, size;
+	unsigned int arrays = 0, slots = 0, populated = 0, i;
+	int warnings = 0;
+	char buf[80];
+
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+
+		switch (h->type)
+		{
+			case 16:
+				arrays++;
+				capacity += sum_memory_array_capacity(h);
+				sum_tally_add(&ecc, sum_field(16, "Error Correction Type",
+							      h, ver, buf, sizeof(buf)));
+				break;
+
+			case 17:
+				slots++;
+				if ((size = dmi_memory_device_size_kb(h)) == 0)
+					break;
+				populated++;
+				installed += size << 10;
+
+				sum_tally_add(&types, sum_field(17, "Type", h, ver,
+								buf, sizeof(buf)));
+				sum_tally_add(&vendors, sum_field(17, "Manufacturer",
+								  h, ver, buf, sizeof(buf)));
+				sum_tally_add(&ranks, sum_field(17, "Rank", h, ver,
+								buf, sizeof(buf)));
+				sum_tally_add(&sizes, sum_field(17, "Size", h, ver,
+								buf, sizeof(buf)));
+				if (sum_memory_device_speed(h))
+					snprintf(buf, sizeof(buf), "%u MT/s",
+						 sum_memory_device_speed(h));
+				else
+					strcpy(buf, "Unknown");
+				sum_tally_add(&speeds, buf);
+				break;
+
+			case 19:
+				mapped += sum_mapped_size(h);
+				break;
+		}
+	}
+
+	sum_begin("memory", "Memory Summary");
+	sum_number("physical_arrays", "Physical Arrays", arrays);
+	sum_size("maximum_capacity_bytes", "Maximum Capacity", capacity);
+	sum_tally("error_correction_types", "Error Correction Types", &ecc);
+	sum_number("slots", "Slots", slots);
+	sum_number("populated_slots", "Populated Slots", populated);
+	sum_number("empty_slots", "Empty Slots", slots - populated);
+	sum_size("installed_size_bytes", "Installed Size", installed);
+	sum_size("mapped_size_bytes", "Mapped Size", mapped);
+	sum_tally("sizes", "Sizes", &sizes);
+	sum_tally("types", "Types", &types);
+	sum_tally("speeds", "Speeds", &speeds);
+	sum_tally("manufacturers", "Manufacturers", &vendors);
+	sum_tally("ranks", "Ranks", &ranks);
+	sum_memory_channels(idx);
+
+	sum_warning(&types, "types", &warnings);
+	sum_warning(&speeds, "speeds", &warnings);
+	sum_warning(&vendors, "manufacturers", &warnings);
+	sum_warning(&ranks, "ranks", &warnings);
+	sum_warning(&sizes, "sizes", &warnings);
+	if (warnings)
+		sum_list_end(0);
+	else if (opt.flags & FLAG_JSON)
+	{
+		sum_list_begin("warnings", "Warnings");
+		sum_list_end(1);
+	}
+	sum_end();
+
+	sum_tally_free(&ecc);
+	sum_tally_free(&types);
+	sum_tally_free(&speeds);
+	sum_tally_free(&vendors);
+	sum_tally_free(&ranks);
+	sum_tally_free(&sizes);
+}
+
+/*
+ * Processors
+ */
+
+/* 7.8 Installed size of the cache of the given handle, in kB */
+static unsigned long long sum_cache_size(const struct dmi_index *idx,
+					 u16 handle)
+{
+	const struct dmi_index_entry *e;
+	const struct dmi_header *h;
+	u16 code;
+
+	if (handle == 0xFFFF || (e = dmi_index_find(idx, handle)) == NULL
+	 || e->h.type != 7 || e->h.length < 0x0F)
+		return 0;
+	h = &e->h;
+
+	if (h->length >= 0x1B)
+		return dmi_cache_size_2_kb(DWORD(h->data + 0x17));
+	code = WORD(h->data + 0x09);
+	return dmi_cache_size_2_kb((((u32)code & 0x8000LU) << 16)
+				   | (code & 0x7FFFLU));
+}
+
+static void sum_processor(const struct dmi_index *idx,
+			  const struct dmi_header *h, u16 ver)
+{
+	unsigned long long cache[3] = { 0, 0, 0 };
+	unsigned int cores, enabled, threads, speed, i;
+	char family[80], version[80], buf[160];
+	const char *socket = dmi_string(h, h->data[0x04]);
+
+	if (!(h->data[0x18] & (1 << 6)))
+	{
+		if (opt.flags & FLAG_JSON)
+		{
+			sum_json_key(NULL, 3);
+			printf("{ \"socket_designation\": ");
+			pr_json_string(socket);
+			printf(", \"populated\": false }");
+		}
+		else
+			pr_list_item("%s: Unpopulated", socket);
+		return;
+	}
+
+	snprintf(family, sizeof(family), "%s",
+		 sum_field(4, "Family", h, ver, buf, sizeof(buf)));
+	snprintf(version, sizeof(version), "%s", dmi_string(h, h->data[0x10]));
+	cores = dmi_processor_count(h, 0x23);
+	enabled = dmi_processor_count(h, 0x24);
+	threads = dmi_processor_count(h, 0x25);
+	speed = WORD(h->data + 0x14);
+	if (h->length >= 0x20)
+		for (i = 0; i < 3; i++)
+			cache[i] = sum_cache_size(idx, WORD(h->data + 0x1A + 2 * i));
+
+	if (opt.flags & FLAG_JSON)
+	{
+		sum_json_key(NULL, 3);
+		printf("{ \"socket_designation\": ");
+		pr_json_string(socket);
+		printf(", \"populated\": true, \"family\": ");
+		pr_json_string(family);
+		printf(", \"version\": ");
+		pr_json_string(version);
+		printf(", \"max_speed_mhz\": %u, \"core_count\": %u, "
+		       "\"core_enabled\": %u, \"thread_count\": %u, "
+		       "\"l1_cache_bytes\": %llu, \"l2_cache_bytes\": %llu, "
+		       "\"l3_cache_bytes\": %llu }",
+		       speed, cores, enabled, threads,
+		       cache[0] << 10, cache[1] << 10, cache[2] << 10);
+		return;
+	}
+
+	pr_list_item("%s: %s, %s, %u MHz, %u cores (%u enabled), %u threads, "
+		     "L1 %llu kB, L2 %llu kB, L3 %llu kB",
+		     socket, family, version, speed, cores, enabled, threads,
+		     cache[0], cache[1], cache[2]);
+}
+
+static void dmi_summary_cpu(const struct dmi_index *idx, u16 ver)
+{
+	unsigned int sockets = 0, populated = 0, cores = 0, threads = 0, i;
+
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+
+		if (h->type != 4 || h->length < 0x1A)
+			continue;
+		sockets++;
+		if (!(h->data[0x18] & (1 << 6)))
+			continue;
+		populated++;
+		cores += dmi_processor_count(h, 0x23);
+		threads += dmi_processor_count(h, 0x25);
+	}
+
+	sum_begin("cpu", "Processor Summary");
+	sum_number("sockets", "Sockets", sockets);
+	sum_number("populated_sockets", "Populated Sockets", populated);
+	sum_number("cores", "Cores", cores);
+	sum_number("threads", "Threads", threads);
+
+	/* One record per socket */
+	sum_list_begin("processors", "Processors");
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+
+		if (h->type == 4 && h->length >= 0x1A)
+			sum_processor(idx, h, ver);
+	}
+	sum_list_end(sockets == 0);
+	sum_end();
+}
+
+/*
+ * Memory errors
+ */
+
+#define SUM_UNKNOWN_ADDRESS	(~0ULL)
+
+/* 7.19 and 7.34 Error addresses, the 64-bit ones are at other offsets */
+static unsigned long long sum_error_address(const struct dmi_header *h,
+					    u8 offset)
+{
+	unsigned long long addr;
+
+	if (h->type == 18)
+		return DWORD(h->data + offset) == 0x80000000 ?
+			SUM_UNKNOWN_ADDRESS : DWORD(h->data + offset);
+	addr = sum_qword(h->data + offset);
+	return addr == 0x8000000000000000ULL ? SUM_UNKNOWN_ADDRESS : addr;
+}
+
+/*
+ * Memory device (type 17), or else memory array (type 16), an error
+ * refers to. Devices and arrays can list a 32-bit error by handle,
+ * otherwise the error address is looked up in the mapped address ranges.
+ */
+static const struct dmi_header *sum_error_location(const struct dmi_index *idx,
+						   const struct dmi_header *h,
+						   unsigned long long addr)
+{
+	const struct dmi_index_entry *e;
+	const struct dmi_header *m;
+	unsigned int i;
+
+	for (i = 0; h->type == 18 && i < idx->count; i++)
+	{
+		m = &idx->entry[i].h;
+		if (m->type == 17 && m->length >= 0x15
+		 && WORD(m->data + 0x06) == h->handle)
+			return m;
+	}
+	if (addr != SUM_UNKNOWN_ADDRESS
+	 && (m = dmi_locate_entry(idx, 20, addr)) != NULL
+	 && (e = dmi_index_find(idx, WORD(m->data + 0x0C))) != NULL
+	 && e->h.type == 17 && e->h.length >= 0x12)
+		return &e->h;
+
+	for (i = 0; h->type == 18 && i < idx->count; i++)
+	{
+		m = &idx->entry[i].h;
+		if (m->type == 16 && m->length >= 0x0F
+		 && WORD(m->data + 0x0B) == h->handle)
+			return m;
+	}
+	if (addr != SUM_UNKNOWN_ADDRESS
+	 && (m = dmi_locate_entry(idx, 19, addr)) != NULL
+	 && (e = dmi_index_find(idx, WORD(m->data + 0x0C))) != NULL
+	 && e->h.type == 16)
+		return &e->h;
+
+	return NULL;
+}
+
+static void sum_json_address(const char *key, unsigned long long addr)
+{
+	if (addr == SUM_UNKNOWN_ADDRESS)
+		printf(", \"%s\": null", key);
+	else
+		printf(", \"%s\": %llu", key, addr);
+}
+
+static void sum_error(const struct dmi_header *h,
+		      const struct dmi_header *loc, u16 ver)
+{
+	char type[40], operation[40], granularity[40], buf[80];
+	u8 dev_offset = h->type == 18 ? 0x0F : 0x13;
+	u8 res_offset = h->type == 18 ? 0x13 : 0x1B;
+	unsigned long long addr = sum_error_address(h, 0x0B);
+	u32 resolution = DWORD(h->data + res_offset);
+	int array = -1;
+
+	snprintf(type, sizeof(type), "%s",
+		 sum_field(h->type, "Type", h, ver, buf, sizeof(buf)));
+	snprintf(operation, sizeof(operation), "%s",
+		 sum_field(h->type, "Operation", h, ver, buf, sizeof(buf)));
+	snprintf(granularity, sizeof(granularity), "%s",
+		 sum_field(h->type, "Granularity", h, ver, buf, sizeof(buf)));
+	if (loc != NULL && loc->type == 16)
+		array = loc->handle;
+	else if (loc != NULL)
+		array = WORD(loc->data + 0x04);
+
+	if (opt.flags & FLAG_JSON)
+	{
+		sum_json_key(NULL, 3);
+		printf("{ \"handle\": %u, \"structure_type\": %u, \"type\": ",
+		       h->handle, h->type);
+		pr_json_string(type);
+		printf(", \"operation\": ");
+		pr_json_string(operation);
+		printf(", \"granularity\": ");
+		pr_json_string(granularity);
+		if (DWORD(h->data + 0x07))
+			printf(", \"vendor_syndrome\": %u", DWORD(h->data + 0x07));
+		else
+			printf(", \"vendor_syndrome\": null");
+		sum_json_address("array_address", addr);
+		sum_json_address("device_address",
+				 sum_error_address(h, dev_offset));
+		sum_json_address("resolution", resolution == 0x80000000 ?
+				 SUM_UNKNOWN_ADDRESS : resolution);
+		if (array < 0)
+			printf(", \"memory_array\": null");
+		else
+			printf(", \"memory_array\": %u", array);
+		if (loc != NULL && loc->type == 17)
+		{
+			printf(", \"memory_device\": { \"handle\": %u, \"locator\": ",
+			       loc->handle);
+			pr_json_string(dmi_string(loc, loc->data[0x10]));
+			printf(", \"bank_locator\": ");
+			pr_json_string(dmi_string(loc, loc->data[0x11]));
+			printf(" } }");
+		}
+		else
+			printf(", \"memory_device\": null }");
+		return;
+	}
+
+	if (addr == SUM_UNKNOWN_ADDRESS)
+		buf[0] = '\0';
+	else
+		snprintf(buf, sizeof(buf), ", at 0x%016llX", addr);
+	if (loc != NULL && loc->type == 17)
+		pr_list_item("0x%04X: %s, %s, %s%s, on %s (%s)", h->handle,
+			     type, operation, granularity, buf,
+			     dmi_string(loc, loc->data[0x10]),
+			     dmi_string(loc, loc->data[0x11]));
+	else if (array >= 0)
+		pr_list_item("0x%04X: %s, %s, %s%s, on array 0x%04X", h->handle,
+			     type, operation, granularity, buf, array);
+	else
+		pr_list_item("0x%04X: %s, %s, %s%s, on unknown device",
+			     h->handle, type, operation, granularity, buf);
+}
+
+/* Structures of type 18 and 33 which don't report an error are skipped */
+static int sum_is_error(const struct dmi_header *h)
+{
+	if (h->type == 18 && h->length >= 0x17)
+		return h->data[0x04] != 0x03;
+	if (h->type == 33 && h->length >= 0x1F)
+		return h->data[0x04] != 0x03;
+	return 0;
+}
+
+static void dmi_summary_errors(const struct dmi_index *idx, u16 ver)
+{
+	struct sum_tally types = { NULL, 0 }, devices = { NULL, 0 };
+	unsigned int structures = 0, errors = 0, i;
+	const struct dmi_header *loc;
+	char buf[80];
+
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+
+		if (h->type == 18 || h->type == 33)
+			structures++;
+		if (!sum_is_error(h))
+			continue;
+		errors++;
+
+		sum_tally_add(&types, sum_field(h->type, "Type", h, ver,
+						buf, sizeof(buf)));
+		loc = sum_error_location(idx, h, sum_error_address(h, 0x0B));
+		if (loc != NULL && loc->type == 17)
+			sum_tally_add(&devices, dmi_string(loc, loc->data[0x10]));
+		else
+		{
+			if (loc != NULL)
+				snprintf(buf, sizeof(buf), "Array 0x%04X",
+					 loc->handle);
+			else
+				strcpy(buf, "Unknown");
+			sum_tally_add(&devices, buf);
+		}
+	}
+
+	sum_begin("errors", "Memory Error Summary");
+	sum_number("structures", "Error Structures", structures);
+	sum_number("errors", "Errors", errors);
+	sum_tally("types", "Error Types", &types);
+	sum_tally("devices", "Devices", &devices);
+
+	/* One record per error */
+	sum_list_begin("records", "Records");
+	for (i = 0; i < idx->count; i++)
+	{
+		const struct dmi_header *h = &idx->entry[i].h;
+
+		if (sum_is_error(h))
+			sum_error(h, sum_error_location(idx, h,
+					sum_error_address(h, 0x0B)), ver);
+	}
+	sum_list_end(errors == 0);
+	sum_end();
+
+	sum_tally_free(&types);
+	sum_tally_free(&devices);
+}
+
+static const struct
+{
+	const char *name;
+	void (*print)(const struct dmi_index *idx, u16 ver);
+} dmi_summaries[] = {
+	{ "memory", dmi_summary_memory },
+	{ "cpu", dmi_summary_cpu },
+	{ "errors", dmi_summary_errors },
+};
+
+/* Returns the bit of the summary in opt.summary, 0 if there is none */
+unsigned int dmi_summary_bit(const char *name)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(dmi_summaries); i++)
+		if (strcmp(dmi_summaries[i].name, name) == 0)
+			return 1 << i;
+	return 0;
+}
+
+void dmi_summary_list(FILE *f)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(dmi_summaries); i++)
+		fprintf(f, "  %s\n", dmi_summaries[i].name);
+}
+
+void dmi_summary(const struct dmi_index *idx, u16 ver)
+{
+	unsigned int i;
+
+	if (opt.flags & FLAG_JSON)
+	{
+		printf("{");
+		sum_first = 1;
+	}
+	for (i = 0; i < ARRAY_SIZE(dmi_summaries); i++)
+		if (opt.summary & (1 << i))
+			dmi_summaries[i].print(idx, ver);
+	if (opt.flags & FLAG_JSON)
+		printf("\n}\n");
+}
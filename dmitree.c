@@ -0,0 +1,312 @@
+/*
+ * Physical containment tree
+ * This file is part of the dmidecode project.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ *
+ * The tree is rooted at the chassis (type 3). A chassis contains the base
+ * boards (type 2) which refer to it by handle, and the elements it lists
+ * by type. A base board contains the entries it lists by handle. Each
+ * entry is displayed once: base boards which don't belong to a known
+ * chassis, and slots (type 9) and onboard devices (type 41) which no base
+ * board lists, are displayed at the top level. Where they are isn't
+ * guessed, even if there is a single base board.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "types.h"
+#include "util.h"
+#include "dmidecode.h"
+#include "dmiopt.h"
+#include "dmioutput.h"
+#include "dmitree.h"
+
+struct dmi_tree
+{
+	const struct dmi_index *idx;
+	u16 ver;
+	u8 seen[0x10000 / 8];	/* Handles already displayed */
+	int first;		/* No sibling was displayed yet (JSON) */
+};
+
+/* Fields which describe an entry, by type */
+static const struct
+{
+	u8 type;
+	const char *name[3];
+} dmi_tree_labels[] = {
+	{ 2, { "Type", "Manufacturer", "Product Name" } },
+	{ 3, { "Type", "Manufacturer", "Version" } },
+	{ 4, { "Socket Designation", "Version", NULL } },
+	{ 9, { "Designation", "Type", "Current Usage" } },
+	{ 17, { "Locator", "Size", NULL } },
+	{ 41, { "Reference Designation", "Type", NULL } },
+};
+
+static int dmi_tree_seen(struct dmi_tree *t, u16 handle)
+{
+	int seen = t->seen[handle >> 3] & (1 << (handle & 7));
+
+	t->seen[handle >> 3] |= 1 << (handle & 7);
+	return seen;
+}
+
+static void dmi_tree_label(const struct dmi_tree *t,
+			   const struct dmi_header *h, char *buf, size_t size)
+{
+	const struct dmi_field *f;
+	const char *value;
+	char tmp[80];
+	size_t len = 0;
+	unsigned int i, j;
+
+	buf[0] = '\0';
+	for (i = 0; i < ARRAY_SIZE(dmi_tree_labels); i++)
+	{
+		if (dmi_tree_labels[i].type != h->type)
+			continue;
+		for (j = 0; j < 3 && dmi_tree_labels[i].name[j]; j++)
+		{
+			f = dmi_field_find(h->type, dmi_tree_labels[i].name[j]);
+			if (f == NULL
+			 || (value = dmi_field_value(f, h, t->ver, tmp,
+						     sizeof(tmp))) == NULL)
+				continue;
+			len += snprintf(buf + len, size - len, "%s%s",
+					len ? ", " : "", value);
+			if (len >= size)
+				return;
+		}
+	}
+}
+
+/* 7.10.8 Segment group, bus and device/function of slots and devices */
+static int dmi_tree_bus_address(const struct dmi_header *h, char *buf,
+				size_t size)
+{
+	const u8 *p;
+
+	if (h->type == 9 && h->length >= 0x11)
+		p = h->data + 0x0D;
+	else if (h->type == 41 && h->length >= 0x0B)
+		p = h->data + 0x07;
+	else
+		return 0;
+
+	if (WORD(p) == 0xFFFF && p[2] == 0xFF && p[3] == 0xFF)
+		return 0;
+	snprintf(buf, size, "%04x:%02x:%02x.%x", WORD(p), p[2], p[3] >> 3,
+		 p[3] & 0x7);
+	return 1;
+}
+
+/*
+ * Output
+ */
+
+static void dmi_tree_indent(int depth)
+{
+	while (depth--)
+		putchar('\t');
+}
+
+static void dmi_tree_json_sep(struct dmi_tree *t, int depth)
+{
+	printf("%s\n%*s", t->first ? "" : ",", 2 * depth, "");
+	t->first = 0;
+}
+
+static void dmi_tree_begin(struct dmi_tree *t, const struct dmi_header *h,
+			   int depth)
+{
+	char label[160], bus[16];
+	int has_bus = dmi_tree_bus_address(h, bus, sizeof(bus));
+
+	dmi_tree_label(t, h, label, sizeof(label));
+
+	if (opt.flags & FLAG_JSON)
+	{
+		dmi_tree_json_sep(t, depth);
+		printf("{ \"handle\": %u, \"type\": %u, \"name\": ",
+		       h->handle, h->type);
+		pr_json_string(dmi_smbios_structure_type(h->type));
+		printf(", \"description\": ");
+		pr_json_string(label);
+		if (has_bus)
+			printf(", \"bus_address\": \"%s\"", bus);
+		printf(", \"children\": [");
+		t->first = 1;
+		return;
+	}
+
+	dmi_tree_indent(depth);
+	printf("%s 0x%04X", dmi_smbios_structure_type(h->type), h->handle);
+	if (label[0])
+		printf(": %s", label);
+	if (has_bus)
+		printf(" (%s)", bus);
+	printf("\n");
+}
+
+static void dmi_tree_end(struct dmi_tree *t, int depth)
+{
+	if (opt.flags & FLAG_JSON)
+	{
+		if (t->first)
+			printf("] }");
+		else
+			printf("\n%*s] }", 2 * depth, "");
+		t->first = 0;
+	}
+}
+
+/* 7.4.4 Elements a chassis contains, by type */
+static void dmi_tree_chassis_elements(struct dmi_tree *t,
+				      const struct dmi_header *h, int depth)
+{
+	const struct dmi_field *board_type = dmi_field_find(2, "Type");
+	const u8 *p = h->data + 0x15;
+	u8 count, len;
+	const char *type;
+	int i;
+
+	if (h->length < 0x15)
+		return;
+	count = h->data[0x13];
+	len = h->data[0x14];
+	if (len < 0x03 || h->length < 0x15 + count * len)
+		return;
+
+	for (i = 0; i < count; i++, p += len)
+	{
+		type = (p[0] & 0x80) ? dmi_smbios_structure_type(p[0] & 0x7F) :
+			dmi_enum_name(board_type->values, p[0] & 0x7F);
+
+		if (opt.flags & FLAG_JSON)
+		{
+			dmi_tree_json_sep(t, depth);
+			printf("{ \"element\": ");
+			pr_json_string(type);
+			printf(", \"minimum\": %u, \"maximum\": %u }", p[1], p[2]);
+		}
+		else
+		{
+			dmi_tree_indent(depth);
+			if (p[1] == p[2])
+				printf("Contained Element: %s (%u)\n", type, p[1]);
+			else
+				printf("Contained Element: %s (%u-%u)\n", type,
+				       p[1], p[2]);
+		}
+	}
+}
+
+/* Slots and onboard devices no base board lists */
+static int dmi_tree_uncontained(const struct dmi_tree *t,
+				const struct dmi_header *h)
+{
+	return (h->type == 9 || h->type == 41)
+		&& !(t->seen[h->handle >> 3] & (1 << (h->handle & 7)));
+}
+
+static void dmi_tree_node(struct dmi_tree *t, const struct dmi_header *h,
+			  int depth)
+{
+	const struct dmi_index *idx = t->idx;
+	unsigned int i;
+
+	dmi_tree_begin(t, h, depth);
+
+	if (h->type == 3)
+	{
+		dmi_tree_chassis_elements(t, h, depth + 1);
+		for (i = 0; i < idx->count; i++)
+		{
+			const struct dmi_header *b = &idx->entry[i].h;
+
+			if (b->type == 2 && b->length >= 0x0F
+			 && WORD(b->data + 0x0B) == h->handle
+			 && !dmi_tree_seen(t, b->handle))
+				dmi_tree_node(t, b, depth + 1);
+		}
+	}
+
+	if (h->type == 2 && h->length >= 0x0F)
+	{
+		u8 count = h->data[0x0E];
+
+		if (h->length < 0x0F + count * 2)
+			count = (h->length - 0x0F) / 2;
+		for (i = 0; i < count; i++)
+		{
+			const struct dmi_index_entry *e;
+
+			e = dmi_index_find(idx, WORD(h->data + 0x0F + 2 * i));
+			if (e != NULL && !dmi_tree_seen(t, e->h.handle))
+				dmi_tree_node(t, &e->h, depth + 1);
+		}
+	}
+
+	dmi_tree_end(t, depth);
+}
+
+void dmi_tree(const struct dmi_index *idx, u16 ver)
+{
+	struct dmi_tree *t;
+	unsigned int i, pass;
+
+	if ((t = calloc(1, sizeof(*t))) == NULL)
+	{
+		perror("calloc");
+		return;
+	}
+	t->idx = idx;
+	t->ver = ver;
+	t->first = 1;
+
+	if (opt.flags & FLAG_JSON)
+		printf("[");
+
+	/* Chassis first, then orphan base boards, then orphan devices */
+	for (pass = 0; pass < 3; pass++)
+	{
+		for (i = 0; i < idx->count; i++)
+		{
+			const struct dmi_header *h = &idx->entry[i].h;
+			const struct dmi_index_entry *c;
+
+			if (pass == 0 && h->type != 3)
+				continue;
+			if (pass == 1
+			 && (h->type != 2 || (h->length >= 0x0F
+			  && (c = dmi_index_find(idx, WORD(h->data + 0x0B))) != NULL
+			  && c->h.type == 3)))
+				continue;
+			if (pass == 2 && !dmi_tree_uncontained(t, h))
+				continue;
+			if (dmi_tree_seen(t, h->handle))
+				continue;
+			dmi_tree_node(t, h, 0);
+		}
+	}
+
+	if (opt.flags & FLAG_JSON)
+		printf(t->first ? "]\n" : "\n]\n");
+
+	free(t);
+}
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+#
+# Benchmark of the --jobs option of dmidecode
+# This file is part of the dmidecode project.
+#
+#   This program is free software; you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation; either version 2 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program; if not, write to the Free Software
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+#
+# Generates a synthetic SMBIOS 3.5 dump with many memory devices (type 17),
+# decodes it with a varying number of jobs, checks that the output is the
+# same as a serial decode, and displays the best time of several runs.
+#
+# Usage: bench-jobs.py [-d DMIDECODE] [-n DEVICES] [-r RUNS] [JOBS...]
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def structure(type, handle, body, *strings):
+	data = struct.pack("<BBH", type, 4 + len(body), handle) + body
+	if not strings:
+		return data + b"\0\0"
+	return data + b"".join(s.encode() + b"\0" for s in strings) + b"\0"
+
+
+def table(devices):
+	out = []
+
+	# BIOS Information (type 0)
+	body = struct.pack("<BBHBBQBBBBBBH", 1, 2, 0xE800, 3, 0xFF,
+			   0x08099880, 0x03, 0x0D, 5, 17, 1, 2, 0x0020)
+	out.append(structure(0, 0x0000, body, "Acme", "1.0", "01/02/2024"))
+
+	# Physical Memory Array (type 16)
+	body = struct.pack("<BBBIHHQ", 3, 3, 6, 0x80000000, 0xFFFE,
+			   devices, devices << 34)
+	out.append(structure(16, 0x0001, body))
+
+	# Memory Device (type 17), SMBIOS 3.2 layout, 16 GB each
+	for i in range(devices):
+		body = struct.pack("<HHHHHBBBBBHH", 0x0001, 0xFFFE, 72, 64,
+				   16384, 0x09, 0, 1, 2, 0x22, 0x2080, 4800)
+		body += struct.pack("<BBBBB", 3, 4, 5, 6, 2)
+		body += struct.pack("<IHHHH", 0, 4800, 1100, 1100, 1100)
+		body += bytes([3]) + struct.pack("<HB", 4, 0)
+		body += struct.pack("<HHHH", 0x2C80, 0, 0, 0)
+		body += bytes(32) + struct.pack("<II", 0, 0)
+		out.append(structure(17, 0x1000 + i, body,
+				     "DIMM %d" % i, "BANK %d" % (i // 8),
+				     "Acme", "SN%08d" % i, "TAG%d" % i,
+				     "PART-%d" % (i % 16)))
+
+	# End Of Table (type 127)
+	out.append(structure(127, 0xFFFE, b""))
+	return b"".join(out)
+
+
+def dump(path, data):
+	ep = bytearray(0x20)
+	ep[0x00:0x05] = b"_SM3_"
+	ep[0x06] = 0x18
+	ep[0x07:0x0A] = bytes([3, 5, 0])
+	ep[0x0A] = 0x01
+	struct.pack_into("<IQ", ep, 0x0C, len(data), len(ep))
+	ep[0x05] = -sum(ep[:0x18]) & 0xFF
+	with open(path, "wb") as f:
+		f.write(bytes(ep) + data)
+
+
+def decode(dmidecode, path, jobs):
+	args = [dmidecode, "--from-dump", path]
+	if jobs > 1:
+		args += ["--jobs", str(jobs)]
+	start = time.monotonic()
+	result = subprocess.run(args, stdout=subprocess.PIPE,
+				stderr=subprocess.PIPE, check=True)
+	return time.monotonic() - start, result.stdout + result.stderr
+
+
+def main():
+	parser = argparse.ArgumentParser(description="Benchmark dmidecode --jobs")
+	parser.add_argument("-d", "--dmidecode", default="./dmidecode")
+	parser.add_argument("-n", "--devices", type=int, default=30000)
+	parser.add_argument("-r", "--runs", type=int, default=5)
+	parser.add_argument("jobs", type=int, nargs="*", default=[1, 2, 4, 8])
+	args = parser.parse_args()
+
+	if not 0 < args.devices <= 0xE000:
+		parser.error("number of devices must be between 1 and 57344")
+
+	fd, path = tempfile.mkstemp(suffix=".bin")
+	os.close(fd)
+	try:
+		dump(path, table(args.devices))
+		print("%d memory devices, %d bytes, %d CPUs" %
+		      (args.devices, os.path.getsize(path), os.cpu_count()))
+
+		_, reference = decode(args.dmidecode, path, 1)
+		for jobs in args.jobs:
+			best = None
+			for _ in range(args.runs):
+				elapsed, output = decode(args.dmidecode, path, jobs)
+				if output != reference:
+					print("%d jobs: output differs from serial decode" % jobs)
+					return 1
+				if best is None or elapsed < best:
+					best = elapsed
+			print("%d jobs: %.3f s" % (jobs, best))
+	finally:
+		os.unlink(path)
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())
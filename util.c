@@ -277,3 +277,20 @@ u64 u64_range(u64 start, u64 end)
 
 	return res;
 }
+
+/*
+ * 64-bit FNV-1a hash, used to compare structures quickly. Pass HASH64_INIT
+ * as the initial value, or a previous result to hash several buffers as one.
+ */
+unsigned long long hash64(const void *buf, size_t len, unsigned long long h)
+{
+	const u8 *p = buf;
+	size_t i;
+
+	for (i = 0; i < len; i++)
+	{
+		h ^= p[i];
+		h *= 0x100000001B3ULL;
+	}
+	return h;
+}
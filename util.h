@@ -24,7 +24,10 @@
 
 #define ARRAY_SIZE(x) (sizeof(x)/sizeof((x)[0]))
 
+#define HASH64_INIT 0xCBF29CE484222325ULL
+
 int checksum(const u8 *buf, size_t len);
 void *read_file(off_t base, size_t *len, const char *filename);
 void *mem_chunk(off_t base, size_t len, const char *devmem);
 u64 u64_range(u64 start, u64 end);
+unsigned long long hash64(const void *buf, size_t len, unsigned long long h);